@@ -0,0 +1,36 @@
+/*
+   Lizard Huffman stream coding entry points (HUF_compress / HUF_decompress from the
+   old FSE library API, as declared in entropy/huf.h), implemented on top of the Huff0
+   coder that is bundled with zstd. Newer zstd versions only expose the workspace based
+   functions, so these wrap them, and handle the uncompressed / RLE cases the same way
+   the old HUF_decompress did.
+*/
+#include <string.h>
+#include "common/huf.h"   /* zstd's lib/common/huf.h */
+#include "common/cpu.h"
+
+static int HUF_zstd_flags(void)
+{
+    static int flags = -1;
+    if (flags < 0)
+        flags = ZSTD_cpuid_bmi2(ZSTD_cpuid()) ? HUF_flags_bmi2 : 0;
+    return flags;
+}
+
+size_t HUF_compress(void* dst, size_t dstCapacity, const void* src, size_t srcSize)
+{
+    U64 workSpace[HUF_WORKSPACE_SIZE_U64];
+    return HUF_compress4X_repeat(dst, dstCapacity, src, srcSize, HUF_SYMBOLVALUE_MAX, HUF_TABLELOG_DEFAULT,
+        workSpace, sizeof(workSpace), NULL, NULL, HUF_zstd_flags());
+}
+
+size_t HUF_decompress(void* dst, size_t originalSize, const void* cSrc, size_t cSrcSize)
+{
+    HUF_CREATE_STATIC_DTABLEX2(dtable, HUF_TABLELOG_MAX);
+    U32 workSpace[HUF_DECOMPRESS_WORKSPACE_SIZE_U32];
+
+    if (cSrcSize == originalSize) { memcpy(dst, cSrc, originalSize); return originalSize; }   /* not compressed */
+    if (cSrcSize == 1) { memset(dst, *(const BYTE*)cSrc, originalSize); return originalSize; }   /* RLE */
+    return HUF_decompress4X_hufOnly_wksp(dtable, dst, originalSize, cSrc, cSrcSize,
+        workSpace, sizeof(workSpace), HUF_zstd_flags());
+}
@@ -153,6 +153,7 @@ struct Lizard_stream_s
     U32   nextToUpdate;     /* index from which to continue dictionary update */
     U32   allocatedMemory;
     int   compressionLevel;
+    U32   stride;           /* element size hint, 0 == any offset */
     Lizard_parameters params;
     U32   hashTableSize;
     U32   chainTableSize;
@@ -217,6 +218,12 @@ struct Lizard_dstream_s
 
 typedef struct Lizard_dstream_s Lizard_dstream_t;
 
+/* stride hint : match candidates at offsets that are a multiple of ctx->stride do not use up
+   searchNum attempts (up to searchNum*LIZARD_STRIDE_BONUS_MULT of them), so chains are searched
+   deeper for element-aligned matches; other candidates are still considered as usual */
+#define LIZARD_STRIDE_BONUS_MULT 8
+#define LIZARD_STRIDE_OK(ctx, offset) ((ctx)->stride == 0 || ((U32)(offset) % (ctx)->stride) == 0)
+
 /* *************************************
 *  HC Pre-defined compression levels
 ***************************************/
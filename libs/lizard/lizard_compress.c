@@ -371,6 +371,7 @@ Lizard_stream_t* Lizard_initStream(Lizard_stream_t* ctx, int compressionLevel)
     ctx->chainTableSize = chainTableSize;
     ctx->params = params;
     ctx->compressionLevel = (unsigned)compressionLevel;
+    ctx->stride = 0;
     if (compressionLevel < 30)
         ctx->huffType = 0;
     else
@@ -606,6 +607,21 @@ int Lizard_compress(const char* src, char* dst, int srcSize, int maxDstSize, int
 }
 
 
+int Lizard_compress_stride(const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel, int stride)
+{
+    int cSize;
+    Lizard_stream_t* statePtr = Lizard_createStream(compressionLevel);
+
+    if (!statePtr) return 0;
+    Lizard_init(statePtr, (const BYTE*)src);
+    statePtr->stride = (stride > 1) ? (U32)stride : 0;
+    cSize = Lizard_compress_generic(statePtr, src, dst, srcSize, maxDstSize);
+
+    Lizard_freeStream(statePtr);
+    return cSize;
+}
+
+
 /**************************************
 *  Level1 functions
 **************************************/
@@ -149,6 +149,16 @@ LIZARDLIB_API int Lizard_sizeofState(int compressionLevel);
 LIZARDLIB_API int Lizard_compress_extState(void* state, const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel);
 
 
+/*!
+Lizard_compress_stride() :
+    Same as Lizard_compress(), with a hint that the data consists of fixed size
+    elements of 'stride' bytes (e.g. interleaved float vectors). The hash chain, lowest price
+    and optimal parsers then search deeper for match candidates whose offset is a multiple of 'stride'.
+    Output format is unchanged; 'stride' <= 1 behaves exactly like Lizard_compress().
+*/
+LIZARDLIB_API int Lizard_compress_stride(const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel, int stride);
+
+
 
 /*-*********************************************
 *  Streaming Compression Functions
@@ -56,6 +56,7 @@ FORCE_INLINE int Lizard_InsertAndFindBestMatch (Lizard_stream_t* ctx,   /* Index
     U32 matchIndex, delta;
     const BYTE* match;
     int nbAttempts=ctx->params.searchNum;
+    int nbStrideBonus = nbAttempts * LIZARD_STRIDE_BONUS_MULT;
     size_t ml=0;
     const int hashLog = ctx->params.hashLog;
     const U32 contentMask = (1 << ctx->params.contentLog) - 1;
@@ -69,6 +70,7 @@ FORCE_INLINE int Lizard_InsertAndFindBestMatch (Lizard_stream_t* ctx,   /* Index
 
     while ((matchIndex < current) && (matchIndex >= lowLimit) && (nbAttempts)) {
         nbAttempts--;
+        if (ctx->stride && nbStrideBonus && LIZARD_STRIDE_OK(ctx, current - matchIndex)) { nbStrideBonus--; nbAttempts++; }
         if (matchIndex >= dictLimit) {
             match = base + matchIndex;
 #if LIZARD_HC_MIN_OFFSET > 0
@@ -124,6 +126,7 @@ FORCE_INLINE int Lizard_InsertAndGetWiderMatch (
     const BYTE* const dictEnd = dictBase + dictLimit;
     U32   matchIndex, delta;
     int nbAttempts = ctx->params.searchNum;
+    int nbStrideBonus = nbAttempts * LIZARD_STRIDE_BONUS_MULT;
     int LLdelta = (int)(ip-iLowLimit);
     const int hashLog = ctx->params.hashLog;
     const U32 contentMask = (1 << ctx->params.contentLog) - 1;
@@ -137,6 +140,7 @@ FORCE_INLINE int Lizard_InsertAndGetWiderMatch (
 
     while ((matchIndex < current) && (matchIndex >= lowLimit) && (nbAttempts)) {
         nbAttempts--;
+        if (ctx->stride && nbStrideBonus && LIZARD_STRIDE_OK(ctx, current - matchIndex)) { nbStrideBonus--; nbAttempts++; }
         if (matchIndex >= dictLimit) {
             const BYTE* match = base + matchIndex;
 #if LIZARD_HC_MIN_OFFSET > 0
@@ -45,6 +45,7 @@ FORCE_INLINE int Lizard_FindMatchLowestPrice (Lizard_stream_t* ctx,   /* Index t
     intptr_t matchIndex;
     const BYTE* match, *matchDict;
     int nbAttempts=ctx->params.searchNum;
+    int nbStrideBonus = nbAttempts * LIZARD_STRIDE_BONUS_MULT;
     size_t ml=0, mlt;
 
     matchIndex = HashTable[Lizard_hashPtr(ip, ctx->params.hashLog, ctx->params.searchLength)];
@@ -96,6 +97,7 @@ FORCE_INLINE int Lizard_FindMatchLowestPrice (Lizard_stream_t* ctx,   /* Index t
     while ((matchIndex < current) && (matchIndex >= lowLimit) && (nbAttempts)) {
         nbAttempts--;
         match = base + matchIndex;
+        if (ctx->stride && nbStrideBonus && LIZARD_STRIDE_OK(ctx, current - matchIndex)) { nbStrideBonus--; nbAttempts++; }
         if ((U32)(ip - match) >= LIZARD_LOWESTPRICE_MIN_OFFSET) {
             if (matchIndex >= dictLimit) {
                 if (*(match+ml) == *(ip+ml) && (MEM_read32(match) == MEM_read32(ip))) {
@@ -146,6 +148,7 @@ FORCE_INLINE size_t Lizard_GetWiderMatch (
     const size_t minMatchLongOff = ctx->params.minMatchLongOff;
     intptr_t matchIndex;
     int nbAttempts = ctx->params.searchNum;
+    int nbStrideBonus = nbAttempts * LIZARD_STRIDE_BONUS_MULT;
     size_t mlt;
 
     /* First Match */
@@ -217,6 +220,7 @@ FORCE_INLINE size_t Lizard_GetWiderMatch (
     while ((matchIndex < current) && (matchIndex >= lowLimit) && (nbAttempts)) {
         nbAttempts--;
         match = base + matchIndex;
+        if (ctx->stride && nbStrideBonus && LIZARD_STRIDE_OK(ctx, current - matchIndex)) { nbStrideBonus--; nbAttempts++; }
         if ((U32)(ip - match) >= LIZARD_LOWESTPRICE_MIN_OFFSET) {
             if (matchIndex >= dictLimit) {
                 if (MEM_read32(match) == MEM_read32(ip)) {
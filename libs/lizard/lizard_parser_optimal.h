@@ -80,6 +80,7 @@ FORCE_INLINE int Lizard_GetAllMatches (
     const size_t minMatchLongOff = ctx->params.minMatchLongOff;
     intptr_t matchIndex;
     int nbAttempts = ctx->params.searchNum;
+    int nbStrideBonus = nbAttempts * LIZARD_STRIDE_BONUS_MULT;
  //   bool fullSearch = (ctx->params.fullSearch >= 2);
     int mnum = 0;
     U32* HashPos;
@@ -127,6 +128,7 @@ FORCE_INLINE int Lizard_GetAllMatches (
     while ((matchIndex < current) && (matchIndex >= lowLimit) && (nbAttempts)) {
         nbAttempts--;
         match = base + matchIndex;
+        if (ctx->stride && nbStrideBonus && LIZARD_STRIDE_OK(ctx, current - matchIndex)) { nbStrideBonus--; nbAttempts++; }
         if ((U32)(ip - match) >= LIZARD_OPTIMAL_MIN_OFFSET) {
             if (matchIndex >= dictLimit) {
                 if ((/*fullSearch ||*/ ip[best_mlen] == match[best_mlen]) && (MEM_readMINMATCH(match) == MEM_readMINMATCH(ip))) {
@@ -199,6 +201,7 @@ FORCE_INLINE int Lizard_BinTree_GetAllMatches (
     const BYTE* match;
     const size_t minMatchLongOff = ctx->params.minMatchLongOff;
     int nbAttempts = ctx->params.searchNum;
+    int nbStrideBonus = nbAttempts * LIZARD_STRIDE_BONUS_MULT;
     int mnum = 0;
     U32 *ptr0, *ptr1, delta0, delta1;
     intptr_t matchIndex;
@@ -247,6 +250,7 @@ FORCE_INLINE int Lizard_BinTree_GetAllMatches (
 
     while ((matchIndex < current) && (matchIndex >= lowLimit) && (nbAttempts)) {
         nbAttempts--;
+        if (ctx->stride && nbStrideBonus && LIZARD_STRIDE_OK(ctx, current - matchIndex)) { nbStrideBonus--; nbAttempts++; }
         if (matchIndex >= dictLimit) {
             match = base + matchIndex;
            // if (ip[mlt] == match[mlt])
@@ -92,6 +92,11 @@ size_t spdp_compress_bound(size_t size) { return size * 2 + 9; }
     }
   }
 
+  return spdp_compress_lz(level, length, buf1, buf2);
+}
+
+size_t spdp_compress_lz(const byte_t level, const size_t length, const byte_t* const buf1, byte_t* const buf2)
+{
   size_t predtabsize = 1 << (level + 9);
   if (predtabsize > MAX_TABLE_SIZE) predtabsize = MAX_TABLE_SIZE;
   const size_t predtabsizem1 = predtabsize - 1;
@@ -101,7 +106,7 @@ size_t spdp_compress_bound(size_t size) { return size * 2 + 9; }
   unsigned int* lastpos = (unsigned int*)calloc(predtabsize, sizeof(unsigned int));
 
   size_t rpos = 0;
-  wpos = 0;
+  size_t wpos = 0;
   unsigned int hist = 0;
   while (rpos < length) {
     byte_t val = buf1[rpos];
@@ -135,6 +140,40 @@ size_t spdp_compress_bound(size_t size) { return size * 2 + 9; }
 }
 
 /*static*/ void spdp_decompress(const byte_t level, const size_t length, byte_t* const buf2, byte_t* const buf1)
+{
+  const size_t usize = spdp_decompress_lz(level, length, buf2, buf1);
+
+  byte_t val = 0;
+  size_t rpos = 0;
+  size_t d;
+  for (d = 0; d < 8; d++) {
+    size_t wpos;
+    for (wpos = d; wpos < usize; wpos += 8) {
+      val += buf1[rpos];
+      buf2[wpos] = val;
+      rpos++;
+    }
+  }
+
+  word_t* in = (word_t*)buf2;
+  word_t* out = (word_t*)buf1;
+  const size_t len = usize / sizeof(word_t);
+
+  word_t prev2 = 0;
+  word_t prev1 = 0;
+  size_t pos;
+  for (pos = 0; pos < len; pos++) {
+    word_t curr = in[pos] + prev2;
+    out[pos] = curr;
+    prev2 = prev1;
+    prev1 = curr;
+  }
+  for (pos = len * sizeof(word_t); pos < usize; pos++) {
+    buf1[pos] = buf2[pos];
+  }
+}
+
+size_t spdp_decompress_lz(const byte_t level, const size_t length, const byte_t* const buf2, byte_t* const buf1)
 {
   unsigned int predtabsize = 1 << (level + 9);
   if (predtabsize > MAX_TABLE_SIZE) predtabsize = MAX_TABLE_SIZE;
@@ -171,37 +210,8 @@ size_t spdp_compress_bound(size_t size) { return size * 2 + 9; }
     wpos++;
     rpos++;
   }
-  const size_t usize = wpos;
-
-  byte_t val = 0;
-  rpos = 0;
-  size_t d;
-  for (d = 0; d < 8; d++) {
-    size_t wpos;
-    for (wpos = d; wpos < usize; wpos += 8) {
-      val += buf1[rpos];
-      buf2[wpos] = val;
-      rpos++;
-    }
-  }
-
-  word_t* in = (word_t*)buf2;
-  word_t* out = (word_t*)buf1;
-  const size_t len = usize / sizeof(word_t);
-
-  word_t prev2 = 0;
-  word_t prev1 = 0;
-  size_t pos;
-  for (pos = 0; pos < len; pos++) {
-    word_t curr = in[pos] + prev2;
-    out[pos] = curr;
-    prev2 = prev1;
-    prev1 = curr;
-  }
-  for (pos = len * sizeof(word_t); pos < usize; pos++) {
-    buf1[pos] = buf2[pos];
-  }
   free(lastpos);
+  return wpos;
 }
 
 /*
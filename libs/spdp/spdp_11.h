@@ -12,6 +12,11 @@ size_t spdp_compress_bound(size_t size);
 size_t spdp_compress(const byte_t level, const size_t length, byte_t* const buf1, byte_t* const buf2);
 void spdp_decompress(const byte_t level, const size_t length, byte_t* const buf2, byte_t* const buf1);
 
+// just the LZ-like byte stage of the above (input of compression: already delta filtered
+// data; decompression returns decompressed size, before undoing the delta filters)
+size_t spdp_compress_lz(const byte_t level, const size_t length, const byte_t* const buf1, byte_t* const buf2);
+size_t spdp_decompress_lz(const byte_t level, const size_t length, const byte_t* const buf2, byte_t* const buf1);
+
 #ifdef __cplusplus
 }
 #endif
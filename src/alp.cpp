@@ -0,0 +1,215 @@
+#include "alp.h"
+#include "bitpack.h"
+#include "simd.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+static const int kAlpMaxExponent = 10;
+static const float kExp10[kAlpMaxExponent + 1] = { 1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f, 100000.0f, 1000000.0f, 10000000.0f, 100000000.0f, 1000000000.0f, 10000000000.0f };
+static const float kFrac10[kAlpMaxExponent + 1] = { 1.0f, 0.1f, 0.01f, 0.001f, 0.0001f, 0.00001f, 0.000001f, 0.0000001f, 0.00000001f, 0.000000001f, 0.0000000001f };
+static const int kAlpSamples = 64;
+static const uint8_t kAlpRawBlock = 0xFF;
+
+struct AlpBlockHeader
+{
+    uint8_t e, f, bits, pad0;
+    uint16_t excCount, pad1;
+    uint32_t base;
+};
+static_assert(sizeof(AlpBlockHeader) == 12);
+
+// v -> integer with exponent e and factor f; false if it does not round-trip exactly
+static inline bool AlpEncode(float v, int e, int f, int32_t& n)
+{
+    float t = v * kExp10[e] * kFrac10[f];
+    if (!(t > -2147483520.0f && t < 2147483520.0f)) // also rejects NaN
+        return false;
+    n = (int32_t)lrintf(t);
+    float d = float(n) * kExp10[f] * kFrac10[e];
+    uint32_t vb, db;
+    memcpy(&vb, &v, 4);
+    memcpy(&db, &d, 4);
+    return vb == db;
+}
+
+static void AlpFindExponents(const float* v, int count, int& bestE, int& bestF)
+{
+    int step = std::max(1, count / kAlpSamples);
+    size_t bestCost = SIZE_MAX;
+    bestE = bestF = 0;
+    for (int e = 0; e <= kAlpMaxExponent; ++e)
+    {
+        for (int f = 0; f <= e; ++f)
+        {
+            int samples = 0, exceptions = 0;
+            int32_t mn = INT32_MAX, mx = INT32_MIN;
+            for (int i = 0; i < count; i += step)
+            {
+                int32_t n;
+                ++samples;
+                if (AlpEncode(v[i], e, f, n))
+                {
+                    mn = std::min(mn, n);
+                    mx = std::max(mx, n);
+                }
+                else
+                    ++exceptions;
+            }
+            int bits = exceptions == samples ? 0 : BitPackWidth(uint32_t(int64_t(mx) - mn));
+            size_t cost = size_t(samples) * bits + exceptions * 48;
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestE = e;
+                bestF = f;
+            }
+        }
+    }
+}
+
+// returns encoded block size
+static size_t AlpCompressBlock(const float* v, int count, uint8_t* dst)
+{
+    AlpBlockHeader* hdr = (AlpBlockHeader*)dst;
+    memset(hdr, 0, sizeof(*hdr));
+    uint8_t* out = dst + sizeof(AlpBlockHeader);
+    const size_t rawSize = sizeof(AlpBlockHeader) + count * 4;
+
+    int e, f;
+    AlpFindExponents(v, count, e, f);
+
+    int32_t ints[kAlpBlockSize];
+    uint16_t excPos[kAlpBlockSize];
+    int excCount = 0;
+    bool haveFill = false;
+    int32_t fill = 0, mn = INT32_MAX, mx = INT32_MIN;
+    for (int i = 0; i < count; ++i)
+    {
+        int32_t n;
+        if (AlpEncode(v[i], e, f, n))
+        {
+            if (!haveFill)
+            {
+                fill = n;
+                haveFill = true;
+            }
+            mn = std::min(mn, n);
+            mx = std::max(mx, n);
+            ints[i] = n;
+        }
+        else
+        {
+            excPos[excCount++] = uint16_t(i);
+            ints[i] = INT32_MIN; // replaced with fill value below
+        }
+    }
+
+    int groups = (count + kBitPackGroup - 1) / kBitPackGroup;
+    int bits = haveFill ? BitPackWidth(uint32_t(int64_t(mx) - mn)) : 0;
+    size_t excSize = ((excCount * 2 + 3) & ~3) + excCount * 4;
+    size_t size = sizeof(AlpBlockHeader) + groups * 16 * bits + excSize;
+    if (!haveFill || size >= rawSize)
+    {
+        hdr->bits = kAlpRawBlock;
+        memcpy(out, v, count * 4);
+        return rawSize;
+    }
+
+    // exceptions and tail padding get a value inside the frame, so they cost no extra bits
+    uint32_t packIn[kAlpBlockSize];
+    for (int i = 0; i < groups * kBitPackGroup; ++i)
+    {
+        int32_t n = i < count ? ints[i] : fill;
+        if (n == INT32_MIN && i < count)
+            n = fill;
+        packIn[i] = uint32_t(n) - uint32_t(mn);
+    }
+    for (int g = 0; g < groups; ++g)
+        BitPack128(packIn + g * kBitPackGroup, (uint32_t*)out + g * 4 * bits, bits);
+    out += groups * 16 * bits;
+
+    memcpy(out, excPos, excCount * 2);
+    out += (excCount * 2 + 3) & ~3;
+    for (int i = 0; i < excCount; ++i)
+        memcpy(out + i * 4, v + excPos[i], 4);
+
+    hdr->e = uint8_t(e);
+    hdr->f = uint8_t(f);
+    hdr->bits = uint8_t(bits);
+    hdr->excCount = uint16_t(excCount);
+    hdr->base = uint32_t(mn);
+    return size;
+}
+
+static size_t AlpDecompressBlock(const uint8_t* src, int count, float* dst)
+{
+    const AlpBlockHeader* hdr = (const AlpBlockHeader*)src;
+    src += sizeof(AlpBlockHeader);
+    if (hdr->bits == kAlpRawBlock)
+    {
+        memcpy(dst, src, count * 4);
+        return sizeof(AlpBlockHeader) + count * 4;
+    }
+    const int bits = hdr->bits;
+    const int groups = (count + kBitPackGroup - 1) / kBitPackGroup;
+    const float mulF = kExp10[hdr->f];
+    const float mulE = kFrac10[hdr->e];
+
+    uint32_t ints[kAlpBlockSize];
+    for (int g = 0; g < groups; ++g)
+        BitUnpack128((const uint32_t*)src + g * 4 * bits, ints + g * kBitPackGroup, bits, hdr->base);
+    src += groups * 16 * bits;
+
+    // decode whole groups in place; tail past count is ignored
+    for (int i = 0; i < groups * kBitPackGroup; i += 4)
+        SimdStore(ints + i, SimdIntToFloatMul(SimdLoad(ints + i), mulF, mulE));
+    memcpy(dst, ints, count * 4);
+
+    const int excCount = hdr->excCount;
+    const uint16_t* excPos = (const uint16_t*)src;
+    src += (excCount * 2 + 3) & ~3;
+    for (int i = 0; i < excCount; ++i)
+        memcpy(dst + excPos[i], src + i * 4, 4);
+    src += excCount * 4;
+    return src - (const uint8_t*)hdr;
+}
+
+size_t alp_compress_bound(size_t dataElems, int channels)
+{
+    size_t blocks = (dataElems + kAlpBlockSize - 1) / kAlpBlockSize;
+    return channels * (blocks * sizeof(AlpBlockHeader) + dataElems * 4);
+}
+
+size_t alp_compress(const float* src, size_t dataElems, int channels, uint8_t* dst)
+{
+    float block[kAlpBlockSize];
+    uint8_t* out = dst;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        for (size_t start = 0; start < dataElems; start += kAlpBlockSize)
+        {
+            int count = int(std::min<size_t>(kAlpBlockSize, dataElems - start));
+            for (int i = 0; i < count; ++i)
+                block[i] = src[(start + i) * channels + ch];
+            out += AlpCompressBlock(block, count, out);
+        }
+    }
+    return out - dst;
+}
+
+void alp_decompress(const uint8_t* src, size_t srcSize, float* dst, size_t dataElems, int channels)
+{
+    float block[kAlpBlockSize];
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        for (size_t start = 0; start < dataElems; start += kAlpBlockSize)
+        {
+            int count = int(std::min<size_t>(kAlpBlockSize, dataElems - start));
+            src += AlpDecompressBlock(src, count, block);
+            float* out = dst + start * channels + ch;
+            for (int i = 0; i < count; ++i)
+                out[i * channels] = block[i];
+        }
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ALP style ("Adaptive Lossless floating-Point", Afroozeh et al. 2023) codec for float32
+// data that originates from decimals: per block of values, finds exponent e and factor f
+// so that v == float(n) * 10^f * 10^-e for integer n, frame-of-reference bit packs
+// the integers, and stores values that do not round-trip as exceptions.
+// Each channel of interleaved input is coded separately, in blocks of kAlpBlockSize values.
+const int kAlpBlockSize = 1024;
+
+size_t alp_compress_bound(size_t dataElems, int channels);
+size_t alp_compress(const float* src, size_t dataElems, int channels, uint8_t* dst);
+void alp_decompress(const uint8_t* src, size_t srcSize, float* dst, size_t dataElems, int channels);
@@ -0,0 +1,97 @@
+#include "bitpack.h"
+#include "simd.h"
+#include <bit>
+#include <array>
+#include <utility>
+
+int BitPackWidth(uint32_t v)
+{
+    return 32 - std::countl_zero(v);
+}
+
+int BitPackWidth(const uint32_t* src, size_t count)
+{
+    uint32_t acc = 0;
+    for (size_t i = 0; i < count; ++i)
+        acc |= src[i];
+    return BitPackWidth(acc);
+}
+
+// bit width as template parameter, so that the loops fully unroll with constant shifts
+template<int Bits>
+static void BitPack128T(const uint32_t* src, uint32_t* dst)
+{
+    const Bytes16 mask = SimdSet1U32(Bits == 32 ? 0xFFFFFFFF : (1u << Bits) - 1);
+    Bytes16 acc = SimdZero();
+    int shift = 0;
+    for (int i = 0; i < kBitPackGroup; i += 4)
+    {
+        Bytes16 v = SimdAnd(SimdLoad(src + i), mask);
+        acc = SimdOr(acc, SimdShiftLeftU32(v, shift));
+        shift += Bits;
+        if (shift >= 32)
+        {
+            SimdStore(dst, acc);
+            dst += 4;
+            shift -= 32;
+            acc = shift > 0 ? SimdShiftRightU32(v, Bits - shift) : SimdZero();
+        }
+        // 32 values per lane, so lane streams always end on a word boundary
+    }
+}
+
+template<int Bits>
+static void BitUnpack128T(const uint32_t* src, uint32_t* dst, uint32_t base)
+{
+    const Bytes16 vbase = SimdSet1U32(base);
+    const Bytes16 mask = SimdSet1U32(Bits == 32 ? 0xFFFFFFFF : (1u << Bits) - 1);
+    Bytes16 cur = SimdLoad(src);
+    src += 4;
+    int shift = 0;
+    for (int i = 0; i < kBitPackGroup; i += 4)
+    {
+        Bytes16 v = SimdShiftRightU32(cur, shift);
+        shift += Bits;
+        if (shift >= 32)
+        {
+            shift -= 32;
+            // last value of a lane ends exactly at a word end; do not read past the group
+            if (i + 4 < kBitPackGroup)
+            {
+                cur = SimdLoad(src);
+                src += 4;
+                if (shift > 0)
+                    v = SimdOr(v, SimdShiftLeftU32(cur, Bits - shift));
+            }
+        }
+        v = SimdAnd(v, mask);
+        SimdStore(dst + i, SimdAddU32(v, vbase));
+    }
+}
+
+// dispatch tables for bit widths 1..32
+template<int... I>
+static constexpr auto MakePackTable(std::integer_sequence<int, I...>) { return std::array{ &BitPack128T<I + 1>... }; }
+template<int... I>
+static constexpr auto MakeUnpackTable(std::integer_sequence<int, I...>) { return std::array{ &BitUnpack128T<I + 1>... }; }
+static constexpr auto kPackTable = MakePackTable(std::make_integer_sequence<int, 32>());
+static constexpr auto kUnpackTable = MakeUnpackTable(std::make_integer_sequence<int, 32>());
+
+void BitPack128(const uint32_t* src, uint32_t* dst, int bits)
+{
+    if (bits == 0)
+        return;
+    kPackTable[bits - 1](src, dst);
+}
+
+void BitUnpack128(const uint32_t* src, uint32_t* dst, int bits, uint32_t base)
+{
+    if (bits == 0)
+    {
+        const Bytes16 vbase = SimdSet1U32(base);
+        for (int i = 0; i < kBitPackGroup; i += 4)
+            SimdStore(dst + i, vbase);
+        return;
+    }
+    kUnpackTable[bits - 1](src, dst, base);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bit packing of groups of 128 uint32 values, "vertical" 4-lane layout like SIMD-BP128:
+// value i goes into lane i%4, each lane is a LSB-first bit stream over every 4th word.
+// A group packed with N bits takes exactly 4*N words (16*N bytes), so unpacking
+// is straight 4-wide SIMD shifts and masks.
+const int kBitPackGroup = 128;
+
+// number of bits needed to represent v
+int BitPackWidth(uint32_t v);
+// max width over count values
+int BitPackWidth(const uint32_t* src, size_t count);
+
+void BitPack128(const uint32_t* src, uint32_t* dst, int bits);
+// unpacks and adds base to each value (for frame-of-reference coding)
+void BitUnpack128(const uint32_t* src, uint32_t* dst, int bits, uint32_t base);
@@ -0,0 +1,74 @@
+#include "bitround.h"
+#include <math.h>
+#include <string.h>
+
+static const int kMantissaBits = 23;
+
+// explicit mantissa bits to keep, for each float exponent value
+static void CalcKeepBits(RoundMode mode, int param, int keepBits[256])
+{
+    for (int e = 0; e < 256; ++e)
+    {
+        int keep = param;
+        if (mode == kRoundDigits)
+        {
+            // value is in [2^e2, 2^(e2+1)); its leading decimal digit exponent e10 is
+            // estimated from below, and quantum 2^p is the largest one <= 10^(e10+1-digits)
+            int e2 = (e == 0 ? 1 : e) - 127;
+            int e10 = (int)floor(e2 * 0.30102999566398120);
+            int p = (int)floor((e10 + 1 - param) * 3.32192809488736235);
+            keep = e2 - p;
+        }
+        keepBits[e] = keep < 0 ? 0 : (keep > kMantissaBits ? kMantissaBits : keep);
+    }
+}
+
+void round_floats(const float* src, float* dst, int channels, size_t dataElems, RoundMode mode, const int* channelParams)
+{
+    const uint32_t* src32 = (const uint32_t*)src;
+    uint32_t* dst32 = (uint32_t*)dst;
+    int keepBits[256];
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const uint32_t* s = src32 + ch;
+        uint32_t* d = dst32 + ch;
+        if (channelParams[ch] < 0)
+        {
+            if (s != d)
+            {
+                for (size_t i = 0; i < dataElems; ++i)
+                    d[i * channels] = s[i * channels];
+            }
+            continue;
+        }
+        CalcKeepBits(mode, channelParams[ch], keepBits);
+        for (size_t i = 0; i < dataElems; ++i)
+        {
+            uint32_t v = s[i * channels];
+            uint32_t exp = (v >> kMantissaBits) & 0xFF;
+            int drop = kMantissaBits - keepBits[exp];
+            if (exp == 0xFF || (v & 0x7FFFFFFF) == 0 || drop == 0)
+            {
+                d[i * channels] = v;
+                continue;
+            }
+            uint32_t mask = ~0u << drop;
+            uint32_t r;
+            if (mode == kRoundBitGroom)
+            {
+                r = (i & 1) ? (v | ~mask) : (v & mask);
+            }
+            else
+            {
+                // round half to even; carry into the exponent is the correct rounding,
+                // except when it would turn the value into infinity: saturate to FLT_MAX
+                // then, which is closer to the input than the rounded up value was
+                uint32_t half = (1u << (drop - 1)) - 1 + ((v >> drop) & 1);
+                r = (v + half) & mask;
+                if (((r >> kMantissaBits) & 0xFF) == 0xFF)
+                    r = (v & 0x80000000) | 0x7F7FFFFF;
+            }
+            d[i * channels] = r;
+        }
+    }
+}
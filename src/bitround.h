@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Lossy pre-filters that drop low mantissa bits of float data, so that the following
+// lossless filter + compressor does better. Output is regular float data; there is
+// no inverse step, so decompression is not affected at all.
+// - Bit grooming (Zender 2016): keep N explicit mantissa bits, alternately zeroing and
+//   setting the rest, so that the errors do not accumulate into a bias.
+// - Bit rounding: round to nearest value with N explicit mantissa bits; relative error
+//   is at most 2^-(N+1).
+// - Digit rounding (Delaunay et al. 2019): keep N significant decimal digits, by rounding
+//   to a power of two quantum picked from the binary exponent; absolute error is at most
+//   half a unit of the N-th decimal digit.
+// Rounding modes never produce infinity: values that would round up past FLT_MAX become
+// +-FLT_MAX instead (error still within the bounds above, but all mantissa bits are set).
+// NaN, infinity and zero values are passed through.
+enum RoundMode
+{
+    kRoundBitGroom,
+    kRoundBits,
+    kRoundDigits,
+};
+
+// Parameters are per channel; negative parameter leaves that channel unchanged.
+// src and dst can be the same.
+void round_floats(const float* src, float* dst, int channels, size_t dataElems, RoundMode mode, const int* channelParams);
@@ -0,0 +1,222 @@
+#include "channeldict.h"
+#include <string.h>
+#include <algorithm>
+
+enum ChannelKind : uint8_t
+{
+    kChannelPlain = 0,
+    kChannelConstant,
+    kChannelDict8,
+    kChannelDict16,
+};
+
+struct ChannelDictHeader
+{
+    uint32_t size;
+    uint16_t channels;
+    uint16_t restChannels;
+    // followed by ChannelKind per channel (padded to 4 bytes), then per channel:
+    // constant: u32 value; dict: u32 count + count u32 values
+};
+
+static const int kDictMaxValues = 65536;
+static const int kDictHashBits = 17;
+
+// open addressing hash set of 32 bit values, remembering insertion index
+struct DictHash
+{
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> slots; // value index + 1; 0 = empty
+    DictHash() : keys(1 << kDictHashBits), slots(1 << kDictHashBits) {}
+
+    void Clear() { std::fill(slots.begin(), slots.end(), 0); }
+    static uint32_t Hash(uint32_t v) { return (v * 2654435761u) >> (32 - kDictHashBits); }
+    uint32_t* Find(uint32_t v, bool& found)
+    {
+        const uint32_t mask = (1 << kDictHashBits) - 1;
+        uint32_t h = Hash(v);
+        while (slots[h] != 0 && keys[h] != v)
+            h = (h + 1) & mask;
+        found = slots[h] != 0;
+        keys[h] = v;
+        return &slots[h];
+    }
+};
+
+// float bits -> unsigned integer with the same ordering as float values
+static inline uint32_t OrderedBits(uint32_t v)
+{
+    return v ^ ((v & 0x80000000) ? 0xFFFFFFFF : 0x80000000);
+}
+
+// collects distinct values of a channel; false if there are more than kDictMaxValues
+static bool CollectDistinct(const uint32_t* src, size_t dataElems, int channels, DictHash& hash, std::vector<uint32_t>& values)
+{
+    hash.Clear();
+    values.clear();
+    for (size_t i = 0; i < dataElems; ++i)
+    {
+        uint32_t v = src[i * channels];
+        bool found;
+        uint32_t* slot = hash.Find(v, found);
+        if (found)
+            continue;
+        if (values.size() == kDictMaxValues)
+            return false;
+        values.push_back(v);
+        *slot = uint32_t(values.size());
+    }
+    return true;
+}
+
+void chdict_encode(const float* src, size_t dataElems, int channels, std::vector<uint8_t>& header, std::vector<float>& rest, int& restChannels)
+{
+    const uint32_t* src32 = (const uint32_t*)src;
+    std::vector<ChannelKind> kinds(channels, kChannelPlain);
+    std::vector<std::vector<uint32_t>> dicts(channels);
+    DictHash hash;
+    std::vector<uint32_t> values;
+
+    size_t kindsSize = (channels + 3) & ~3;
+    header.assign(sizeof(ChannelDictHeader) + kindsSize, 0);
+    int plainCount = 0, indexBytes = 0;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        if (CollectDistinct(src32 + ch, dataElems, channels, hash, values))
+        {
+            if (values.size() <= 1)
+                kinds[ch] = kChannelConstant;
+            else
+            {
+                // only worth it if dictionary costs well below the saved index bytes
+                int idxSize = values.size() <= 256 ? 1 : 2;
+                if (values.size() * 4 * 2 < dataElems * (4 - idxSize))
+                    kinds[ch] = idxSize == 1 ? kChannelDict8 : kChannelDict16;
+            }
+        }
+        if (kinds[ch] == kChannelConstant)
+        {
+            uint32_t v = dataElems ? src32[ch] : 0;
+            header.insert(header.end(), (const uint8_t*)&v, (const uint8_t*)&v + 4);
+        }
+        else if (kinds[ch] == kChannelDict8 || kinds[ch] == kChannelDict16)
+        {
+            // sorted dictionary, so that index deltas follow value deltas
+            std::sort(values.begin(), values.end(), [](uint32_t a, uint32_t b) { return OrderedBits(a) < OrderedBits(b); });
+            uint32_t count = uint32_t(values.size());
+            header.insert(header.end(), (const uint8_t*)&count, (const uint8_t*)&count + 4);
+            header.insert(header.end(), (const uint8_t*)values.data(), (const uint8_t*)(values.data() + count));
+            dicts[ch] = values;
+            indexBytes += kinds[ch] == kChannelDict8 ? 1 : 2;
+        }
+        else
+            ++plainCount;
+        header[sizeof(ChannelDictHeader) + ch] = kinds[ch];
+    }
+
+    restChannels = plainCount + (indexBytes + 3) / 4;
+    ChannelDictHeader* hdr = (ChannelDictHeader*)header.data();
+    hdr->size = uint32_t(header.size());
+    hdr->channels = uint16_t(channels);
+    hdr->restChannels = uint16_t(restChannels);
+
+    rest.assign(dataElems * restChannels, 0.0f);
+    uint32_t* rest32 = (uint32_t*)rest.data();
+    int plainIdx = 0, byteIdx = plainCount * 4;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const uint32_t* s = src32 + ch;
+        if (kinds[ch] == kChannelPlain)
+        {
+            for (size_t i = 0; i < dataElems; ++i)
+                rest32[i * restChannels + plainIdx] = s[i * channels];
+            ++plainIdx;
+        }
+        else if (kinds[ch] == kChannelDict8 || kinds[ch] == kChannelDict16)
+        {
+            // map value -> sorted index through the hash table
+            hash.Clear();
+            const std::vector<uint32_t>& dict = dicts[ch];
+            for (size_t j = 0; j < dict.size(); ++j)
+            {
+                bool found;
+                *hash.Find(dict[j], found) = uint32_t(j + 1);
+            }
+            uint8_t* dst = (uint8_t*)rest32 + byteIdx;
+            const size_t rowBytes = restChannels * 4;
+            for (size_t i = 0; i < dataElems; ++i)
+            {
+                bool found;
+                uint32_t idx = *hash.Find(s[i * channels], found) - 1;
+                dst[i * rowBytes] = uint8_t(idx);
+                if (kinds[ch] == kChannelDict16)
+                    dst[i * rowBytes + 1] = uint8_t(idx >> 8);
+            }
+            byteIdx += kinds[ch] == kChannelDict8 ? 1 : 2;
+        }
+    }
+}
+
+size_t chdict_get_header_size(const uint8_t* header)
+{
+    return ((const ChannelDictHeader*)header)->size;
+}
+
+int chdict_get_rest_channels(const uint8_t* header)
+{
+    return ((const ChannelDictHeader*)header)->restChannels;
+}
+
+void chdict_decode(const uint8_t* header, const float* rest, float* dst, size_t dataElems, int channels)
+{
+    const ChannelDictHeader* hdr = (const ChannelDictHeader*)header;
+    const int restChannels = hdr->restChannels;
+    const uint8_t* kinds = header + sizeof(ChannelDictHeader);
+    int plainCount = 0;
+    for (int ch = 0; ch < channels; ++ch)
+        plainCount += kinds[ch] == kChannelPlain ? 1 : 0;
+
+    const uint8_t* payload = kinds + ((channels + 3) & ~3);
+    const uint32_t* rest32 = (const uint32_t*)rest;
+    uint32_t* dst32 = (uint32_t*)dst;
+    const size_t rowBytes = restChannels * 4;
+    int plainIdx = 0, byteIdx = plainCount * 4;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        uint32_t* d = dst32 + ch;
+        if (kinds[ch] == kChannelPlain)
+        {
+            for (size_t i = 0; i < dataElems; ++i)
+                d[i * channels] = rest32[i * restChannels + plainIdx];
+            ++plainIdx;
+        }
+        else if (kinds[ch] == kChannelConstant)
+        {
+            uint32_t v;
+            memcpy(&v, payload, 4);
+            payload += 4;
+            for (size_t i = 0; i < dataElems; ++i)
+                d[i * channels] = v;
+        }
+        else
+        {
+            uint32_t count;
+            memcpy(&count, payload, 4);
+            const uint32_t* dict = (const uint32_t*)(payload + 4);
+            payload += 4 + count * 4;
+            const uint8_t* idx = (const uint8_t*)rest + byteIdx;
+            if (kinds[ch] == kChannelDict8)
+            {
+                for (size_t i = 0; i < dataElems; ++i)
+                    d[i * channels] = dict[idx[i * rowBytes]];
+                byteIdx += 1;
+            }
+            else
+            {
+                for (size_t i = 0; i < dataElems; ++i)
+                    d[i * channels] = dict[idx[i * rowBytes] | (idx[i * rowBytes + 1] << 8)];
+                byteIdx += 2;
+            }
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// Pre-pass that takes out constant and low cardinality channels of interleaved float data.
+// Constant channels are stored as one value; channels with up to 256 / 65536 distinct
+// values are stored as a sorted dictionary plus 8 / 16 bit indices. Remaining channels,
+// followed by the packed index bytes of all dictionary channels (padded to 4 bytes), form
+// the "rest" data with restChannels floats per element that goes to the regular
+// filter + compressor.
+// Header (dictionaries, constants) is returned in `header`; its first 4 bytes are its size.
+void chdict_encode(const float* src, size_t dataElems, int channels, std::vector<uint8_t>& header, std::vector<float>& rest, int& restChannels);
+
+size_t chdict_get_header_size(const uint8_t* header);
+int chdict_get_rest_channels(const uint8_t* header);
+// Rebuilds full data from header and decompressed rest data. Constant channels are
+// only filled in, without touching the rest data.
+void chdict_decode(const uint8_t* header, const float* rest, float* dst, size_t dataElems, int channels);
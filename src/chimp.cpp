@@ -0,0 +1,287 @@
+#include "chimp.h"
+#include <bit>
+#include <string.h>
+#include <vector>
+
+// Bit streams are LSB-first; writer ORs into a zeroed buffer, reader does one unaligned
+// 64 bit load per symbol (at least 57 valid bits), so buffers need 8 bytes of padding.
+struct BitWriter
+{
+    uint8_t* buf;
+    size_t pos = 0;
+
+    BitWriter(uint8_t* buf_) : buf(buf_) {}
+    void Put(uint64_t v, int n) // n <= 57
+    {
+        uint8_t* p = buf + (pos >> 3);
+        uint64_t w;
+        memcpy(&w, p, 8);
+        w |= v << (pos & 7);
+        memcpy(p, &w, 8);
+        pos += n;
+    }
+};
+
+struct BitReader
+{
+    const uint8_t* buf;
+    size_t pos = 0;
+
+    BitReader(const uint8_t* buf_) : buf(buf_) {}
+    uint64_t Peek() const
+    {
+        uint64_t w;
+        memcpy(&w, buf + (pos >> 3), 8);
+        return w >> (pos & 7);
+    }
+    uint32_t Get(int n) // n <= 32
+    {
+        uint64_t v = Peek() & ((1ull << n) - 1);
+        pos += n;
+        return uint32_t(v);
+    }
+};
+
+static size_t ChannelBound(size_t dataElems)
+{
+    // worst case per value: Gorilla 2+5+5+32 bits, Chimp128 2+7+3+5+32 bits
+    return (dataElems * 49 + 7) / 8 + 8;
+}
+
+size_t chimp_compress_bound(size_t dataElems, int channels)
+{
+    return channels * 4 + ChannelBound(dataElems) * channels + 8;
+}
+
+// Gorilla, float32: '0' same as previous; '10' xor fits into previous leading/trailing
+// zero window; '11' + 5 bit leading zeros + 5 bit (length-1) + meaningful bits.
+static void GorillaEncode(const uint32_t* src, size_t count, int stride, BitWriter& bw)
+{
+    uint32_t prev = src[0];
+    bw.Put(prev, 32);
+    int prevLead = 32, prevTrail = 0;
+    for (size_t i = 1; i < count; ++i)
+    {
+        uint32_t v = src[i * stride];
+        uint32_t x = v ^ prev;
+        prev = v;
+        if (x == 0)
+        {
+            bw.Put(0, 1);
+            continue;
+        }
+        int lead = std::countl_zero(x);
+        int trail = std::countr_zero(x);
+        if (lead >= prevLead && trail >= prevTrail)
+        {
+            bw.Put(1, 2);
+            bw.Put(x >> prevTrail, 32 - prevLead - prevTrail);
+        }
+        else
+        {
+            int sig = 32 - lead - trail;
+            bw.Put(3 | (lead << 2) | ((sig - 1) << 7), 12);
+            bw.Put(x >> trail, sig);
+            prevLead = lead;
+            prevTrail = trail;
+        }
+    }
+}
+
+static void GorillaDecode(BitReader& br, uint32_t* dst, size_t count, int stride)
+{
+    uint32_t prev = br.Get(32);
+    dst[0] = prev;
+    int winShift = 0, winLen = 0;
+    uint64_t winMask = 0;
+    for (size_t i = 1; i < count; ++i)
+    {
+        uint64_t w = br.Peek();
+        if (w & 1)
+        {
+            if (w & 2)
+            {
+                int lead = int(w >> 2) & 31;
+                int sig = (int(w >> 7) & 31) + 1;
+                winShift = 32 - lead - sig;
+                winLen = sig;
+                winMask = (1ull << sig) - 1;
+                br.pos += 12;
+                w = br.Peek();
+                br.pos += sig;
+            }
+            else
+            {
+                w >>= 2;
+                br.pos += 2 + winLen;
+            }
+            prev ^= uint32_t((w & winMask) << winShift);
+        }
+        else
+        {
+            br.pos += 1;
+        }
+        dst[i * stride] = prev;
+    }
+}
+
+// Chimp128, float32: 2 bit flag,
+// '00' + 7 bit index: same as one of previous 128 values;
+// '01' + 7 bit index + 3 bit leading zeros + 5 bit length + centre bits: many trailing zeros
+//      when XORed with value at index;
+// '10': XOR with previous value, same leading zeros as last time;
+// '11' + 3 bit leading zeros: XOR with previous value.
+static const int kChimpRingLog2 = 7;
+static const int kChimpRingSize = 1 << kChimpRingLog2;
+static const int kChimpThreshold = 5 + kChimpRingLog2;
+static const uint32_t kChimpKeyMask = (1u << (kChimpThreshold + 1)) - 1;
+static const uint8_t kChimpLeadRound[8] = { 0, 8, 12, 16, 18, 20, 22, 24 };
+
+static uint8_t ChimpLeadCode(int lead)
+{
+    if (lead >= 24) return 7;
+    if (lead >= 16) return uint8_t(3 + ((lead - 16) >> 1));
+    if (lead >= 12) return 2;
+    if (lead >= 8) return 1;
+    return 0;
+}
+
+static void Chimp128Encode(const uint32_t* src, size_t count, int stride, BitWriter& bw)
+{
+    uint32_t ring[kChimpRingSize];
+    std::vector<size_t> indices(kChimpKeyMask + 1, 0);
+    uint32_t v = src[0];
+    bw.Put(v, 32);
+    ring[0] = v;
+    indices[v & kChimpKeyMask] = 0;
+    int storedLead = 33;
+    for (size_t i = 1; i < count; ++i)
+    {
+        v = src[i * stride];
+        uint32_t key = v & kChimpKeyMask;
+        size_t curIndex = indices[key];
+        int refIndex = int((i - 1) % kChimpRingSize);
+        uint32_t x = ring[refIndex] ^ v;
+        if (i - curIndex <= kChimpRingSize)
+        {
+            uint32_t tx = v ^ ring[curIndex % kChimpRingSize];
+            if (std::countr_zero(tx) > kChimpThreshold)
+            {
+                refIndex = int(curIndex % kChimpRingSize);
+                x = tx;
+            }
+        }
+
+        if (x == 0)
+        {
+            bw.Put(refIndex << 2, 2 + kChimpRingLog2);
+            storedLead = 33;
+        }
+        else
+        {
+            int leadCode = ChimpLeadCode(std::countl_zero(x));
+            int lead = kChimpLeadRound[leadCode];
+            int trail = std::countr_zero(x);
+            if (trail > kChimpThreshold)
+            {
+                int sig = 32 - lead - trail;
+                bw.Put(1 | (refIndex << 2) | (leadCode << 9) | (sig << 12), 17);
+                bw.Put(x >> trail, sig);
+                storedLead = 33;
+            }
+            else if (lead == storedLead)
+            {
+                bw.Put(2, 2);
+                bw.Put(x, 32 - lead);
+            }
+            else
+            {
+                storedLead = lead;
+                bw.Put(3 | (leadCode << 2), 5);
+                bw.Put(x, 32 - lead);
+            }
+        }
+        ring[i % kChimpRingSize] = v;
+        indices[key] = i;
+    }
+}
+
+static void Chimp128Decode(BitReader& br, uint32_t* dst, size_t count, int stride)
+{
+    uint32_t ring[kChimpRingSize];
+    uint32_t v = br.Get(32);
+    ring[0] = v;
+    dst[0] = v;
+    int storedLead = 0;
+    for (size_t i = 1; i < count; ++i)
+    {
+        uint64_t w = br.Peek();
+        uint32_t prev = ring[(i - 1) % kChimpRingSize];
+        switch (w & 3)
+        {
+        case 0:
+            v = ring[(w >> 2) & (kChimpRingSize - 1)];
+            br.pos += 2 + kChimpRingLog2;
+            break;
+        case 1:
+        {
+            int lead = kChimpLeadRound[(w >> 9) & 7];
+            int sig = int(w >> 12) & 31;
+            br.pos += 17;
+            v = ring[(w >> 2) & (kChimpRingSize - 1)] ^ (br.Get(sig) << (32 - lead - sig));
+            break;
+        }
+        case 2:
+            br.pos += 2;
+            v = prev ^ br.Get(32 - storedLead);
+            break;
+        case 3:
+            storedLead = kChimpLeadRound[(w >> 2) & 7];
+            br.pos += 5;
+            v = prev ^ br.Get(32 - storedLead);
+            break;
+        }
+        ring[i % kChimpRingSize] = v;
+        dst[i * stride] = v;
+    }
+}
+
+size_t chimp_compress(ChimpVariant variant, const float* src, size_t dataElems, int channels, uint8_t* dst)
+{
+    size_t bound = chimp_compress_bound(dataElems, channels);
+    memset(dst, 0, bound);
+    uint32_t* chSizes = (uint32_t*)dst;
+    size_t offset = channels * 4;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        BitWriter bw(dst + offset);
+        if (dataElems > 0)
+        {
+            if (variant == kChimpGorilla)
+                GorillaEncode((const uint32_t*)src + ch, dataElems, channels, bw);
+            else
+                Chimp128Encode((const uint32_t*)src + ch, dataElems, channels, bw);
+        }
+        size_t size = (bw.pos + 7) / 8;
+        chSizes[ch] = uint32_t(size);
+        offset += size;
+    }
+    return offset + 8;
+}
+
+void chimp_decompress(ChimpVariant variant, const uint8_t* src, size_t srcSize, float* dst, size_t dataElems, int channels)
+{
+    if (dataElems == 0)
+        return;
+    const uint32_t* chSizes = (const uint32_t*)src;
+    size_t offset = channels * 4;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        BitReader br(src + offset);
+        if (variant == kChimpGorilla)
+            GorillaDecode(br, (uint32_t*)dst + ch, dataElems, channels);
+        else
+            Chimp128Decode(br, (uint32_t*)dst + ch, dataElems, channels);
+        offset += chSizes[ch];
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// XOR based float time series codecs, float32 flavors of:
+// - Gorilla (Pelkonen et al. 2015): XOR with previous value, leading/trailing zero window reuse.
+// - Chimp128 (Liakos et al. 2022): XOR with the best of 128 previous values (picked via
+//   a hash of low bits), rounded leading zero counts, trailing zero aware encoding.
+// Each channel of interleaved input is coded as a separate bit stream.
+enum ChimpVariant
+{
+    kChimpGorilla = 0,
+    kChimpChimp128,
+};
+
+size_t chimp_compress_bound(size_t dataElems, int channels);
+size_t chimp_compress(ChimpVariant variant, const float* src, size_t dataElems, int channels, uint8_t* dst);
+void chimp_decompress(ChimpVariant variant, const uint8_t* src, size_t srcSize, float* dst, size_t dataElems, int channels);
@@ -0,0 +1,408 @@
+#include "cm.h"
+#include "parallel.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+static const int kCmBandRows = 128;
+static const int kCmBandElems1D = 256 * 1024;
+// memory for models of all the bands that are coded at the same time
+static const size_t kCmMemoryBudget = size_t(256) << 20;
+static const int kCmMinTableBits = 16;
+static const int kCmContexts = 7;
+static const int kCmInputs = kCmContexts + 1; // plus bias input
+static const int kCmCounterLimit = 127;
+static const int kCmInitWeight = 1 << 14; // 0.25 in 16.16 fixed point
+static const int kCmMixerRate = 2;
+static const int kCmApmRate = 7;
+static const int kCmApmContexts = 256 * 256; // partial byte x predicted byte
+
+struct CmHeader
+{
+    uint32_t tableBits;
+    uint32_t bandCount;
+    // followed by uint32_t band sizes (size equal to uncompressed band size: stored as is),
+    // then band data
+};
+
+// range of elements, in whole rows for 2D data
+struct CmBand
+{
+    size_t start, count;
+};
+
+static int CmBandCount(int width, int height)
+{
+    if (height == 1)
+        return (width + kCmBandElems1D - 1) / kCmBandElems1D;
+    return (height + kCmBandRows - 1) / kCmBandRows;
+}
+
+static CmBand CmGetBand(int width, int height, int index)
+{
+    CmBand b;
+    if (height == 1)
+    {
+        b.start = size_t(index) * kCmBandElems1D;
+        b.count = std::min<size_t>(kCmBandElems1D, width - b.start);
+    }
+    else
+    {
+        int y0 = index * kCmBandRows;
+        b.start = size_t(y0) * width;
+        b.count = size_t(std::min(kCmBandRows, height - y0)) * width;
+    }
+    return b;
+}
+
+// logistic function: stretch domain (-2047..2047, 8 bit fraction) -> 12 bit probability
+static int CmSquash(int d)
+{
+    static const int t[33] = {
+        1, 2, 3, 6, 10, 16, 27, 45, 73, 120, 194, 310, 488, 747, 1101, 1546,
+        2047, 2549, 2994, 3348, 3607, 3785, 3901, 3975, 4022, 4050, 4068, 4079, 4085, 4089, 4092, 4093, 4094 };
+    if (d > 2047)
+        return 4095;
+    if (d < -2047)
+        return 1;
+    int w = d & 127;
+    d = (d >> 7) + 16;
+    return (t[d] * (128 - w) + t[d + 1] * w + 64) >> 7;
+}
+
+struct CmTables
+{
+    int16_t stretch[4096]; // inverse of squash
+    int dt[1024]; // counter adaptation rates, 1/(n+1.5)
+
+    CmTables()
+    {
+        int pi = 0;
+        for (int x = -2047; x <= 2047; ++x)
+        {
+            int v = CmSquash(x);
+            for (int j = pi; j <= v; ++j)
+                stretch[j] = int16_t(x);
+            pi = v + 1;
+        }
+        for (int j = pi; j < 4096; ++j)
+            stretch[j] = 2047;
+        for (int i = 0; i < 1024; ++i)
+            dt[i] = 16384 / (i + i + 3);
+    }
+};
+static const CmTables g_CmTables;
+
+static inline uint32_t CmHash(uint32_t a, uint32_t b)
+{
+    uint32_t h = a * 0x9E3779B1u ^ (b + 1) * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 13;
+    return h;
+}
+
+struct CmModel
+{
+    int tableBits = 0;
+    std::vector<uint32_t> counters; // per context 2^tableBits counters: 22 bit probability, 10 bit count
+    std::vector<int32_t> weights; // mixer weight sets, per byte plane and partial byte
+    std::vector<uint16_t> apm; // per APM context 33 interpolation buckets, 16 bit probabilities
+
+    static size_t GetMemorySize(int tableBits)
+    {
+        return (size_t(kCmContexts) << tableBits) * 4 + 4 * 256 * kCmInputs * 4 + kCmApmContexts * 33 * 2;
+    }
+
+    void Reset(int bits)
+    {
+        tableBits = bits;
+        counters.assign(size_t(kCmContexts) << bits, 1u << 31);
+        weights.assign(4 * 256 * kCmInputs, kCmInitWeight);
+        apm.resize(size_t(kCmApmContexts) * 33);
+        for (int j = 0; j < 33; ++j)
+            apm[j] = uint16_t(CmSquash((j - 16) * 128) * 16);
+        for (int c = 1; c < kCmApmContexts; ++c)
+            memcpy(apm.data() + c * 33, apm.data(), 33 * 2);
+    }
+};
+
+static inline void CmUpdateCounter(uint32_t& t, int bit)
+{
+    const int n = t & 1023;
+    const int p = int(t >> 10);
+    if (n < kCmCounterLimit)
+        ++t;
+    t += uint32_t(int64_t(((bit << 22) - p) >> 3) * g_CmTables.dt[n]) & 0xfffffc00u;
+}
+
+// carry-less binary arithmetic coder (lpaq); p is 12 bit probability of a one bit
+struct CmEncoder
+{
+    std::vector<uint8_t>& out;
+    uint32_t x1 = 0, x2 = 0xffffffff;
+
+    CmEncoder(std::vector<uint8_t>& o) : out(o) {}
+    int Code(int bit, int p)
+    {
+        const uint32_t xmid = x1 + ((x2 - x1) >> 12) * p;
+        if (bit)
+            x2 = xmid;
+        else
+            x1 = xmid + 1;
+        while (((x1 ^ x2) & 0xff000000) == 0)
+        {
+            out.push_back(uint8_t(x2 >> 24));
+            x1 <<= 8;
+            x2 = (x2 << 8) | 255;
+        }
+        return bit;
+    }
+    void Flush()
+    {
+        for (int i = 0; i < 4; ++i, x1 <<= 8)
+            out.push_back(uint8_t(x1 >> 24));
+    }
+};
+
+struct CmDecoder
+{
+    const uint8_t* ptr;
+    const uint8_t* end;
+    uint32_t x1 = 0, x2 = 0xffffffff, x = 0;
+
+    CmDecoder(const uint8_t* src, size_t size) : ptr(src), end(src + size)
+    {
+        for (int i = 0; i < 4; ++i)
+            x = (x << 8) | Next();
+    }
+    uint32_t Next() { return ptr < end ? *ptr++ : 0; }
+    int Code(int, int p)
+    {
+        const uint32_t xmid = x1 + ((x2 - x1) >> 12) * p;
+        const int bit = x <= xmid;
+        if (bit)
+            x2 = xmid;
+        else
+            x1 = xmid + 1;
+        while (((x1 ^ x2) & 0xff000000) == 0)
+        {
+            x1 <<= 8;
+            x2 = (x2 << 8) | 255;
+            x = (x << 8) | Next();
+        }
+        return bit;
+    }
+};
+
+// Codes one channel of a band, byte planes from highest to lowest. Encoder and decoder run
+// the same code: when decoding, vals start out zero and get filled plane by plane; contexts
+// only ever look at the parts that are already known to the decoder.
+template<typename Coder>
+static void CmCodeChannel(CmModel& m, Coder& coder, uint32_t* vals, size_t count, size_t width, int channel)
+{
+    const int bits = m.tableBits;
+    for (int plane = 3; plane >= 0; --plane)
+    {
+        const int shift = plane * 8;
+        const uint32_t maskCur = ~0u << shift;
+        const uint32_t maskHi = plane == 3 ? 0 : ~0u << (shift + 8);
+        uint32_t salt[kCmContexts];
+        for (int k = 0; k < kCmContexts; ++k)
+            salt[k] = CmHash(uint32_t(channel) * 64 + plane * 8 + k, 0);
+        int32_t* planeWeights = m.weights.data() + plane * 256 * kCmInputs;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            // known: higher planes of current element, this plane and higher of previous ones
+            const uint32_t cur = vals[i] & maskHi;
+            const uint32_t l = i > 0 ? vals[i - 1] & maskCur : 0;
+            uint32_t u = 0, pred;
+            if (i >= width)
+            {
+                u = vals[i - width] & maskCur;
+                const uint32_t ul = i > width ? vals[i - width - 1] & maskCur : 0;
+                pred = l + u - ul; // Lorenzo
+            }
+            else
+            {
+                const uint32_t ll = i > 1 ? vals[i - 2] & maskCur : 0;
+                pred = l + l - ll; // linear
+            }
+            const uint32_t lb = (l >> shift) & 255, ub = (u >> shift) & 255, pb = (pred >> shift) & 255;
+            const uint32_t hb1 = plane < 3 ? (cur >> (shift + 8)) & 255 : 0;
+            const uint32_t hb2 = plane < 2 ? (cur >> (shift + 16)) & 255 : 0;
+            const uint32_t lhb = plane < 3 ? (l >> (shift + 8)) & 255 : 0;
+            const uint32_t predHit = (pred & maskHi) == cur;
+            const uint32_t ctx[kCmContexts] = {
+                salt[0],
+                CmHash(salt[1], lb | hb1 << 8),
+                CmHash(salt[2], ub | hb1 << 8),
+                CmHash(salt[3], hb1 | hb2 << 8),
+                CmHash(salt[4], lb | ub << 8),
+                CmHash(salt[5], pb | predHit << 8 | hb1 << 9),
+                CmHash(salt[6], lb | lhb << 8 | hb1 << 16),
+            };
+
+            const uint32_t byte = (vals[i] >> shift) & 255;
+            uint32_t base[kCmContexts];
+            uint32_t c0 = 1, nib = 1;
+            for (int b = 7; b >= 0; --b)
+            {
+                // 16 counter bucket per nibble of each context
+                if (b == 7 || b == 3)
+                {
+                    for (int k = 0; k < kCmContexts; ++k)
+                        base[k] = (uint32_t(k) << bits) + ((CmHash(ctx[k], c0) >> (32 - bits)) & ~15u);
+                    nib = 1;
+                }
+                uint32_t* slots[kCmContexts];
+                int st[kCmInputs];
+                for (int k = 0; k < kCmContexts; ++k)
+                {
+                    slots[k] = &m.counters[base[k] + nib];
+                    st[k] = g_CmTables.stretch[*slots[k] >> 20];
+                }
+                st[kCmContexts] = 256;
+
+                int32_t* w = planeWeights + c0 * kCmInputs;
+                int64_t dot = 0;
+                for (int k = 0; k < kCmInputs; ++k)
+                    dot += int64_t(st[k]) * w[k];
+                const int pMix = CmSquash(int(std::clamp<int64_t>(dot >> 16, -2047, 2047)));
+
+                const int s = g_CmTables.stretch[pMix] + 2048;
+                const int wt = s & 127;
+                uint16_t* a = &m.apm[(c0 | pb << 8) * 33 + (s >> 7)];
+                const int pApm = (a[0] * (128 - wt) + a[1] * wt) >> 11;
+                const int p = std::clamp((pMix + 3 * pApm) >> 2, 1, 4095);
+
+                const int bit = coder.Code((byte >> b) & 1, p);
+
+                for (int k = 0; k < kCmContexts; ++k)
+                    CmUpdateCounter(*slots[k], bit);
+                const int err = ((bit << 12) - pMix) * kCmMixerRate;
+                for (int k = 0; k < kCmInputs; ++k)
+                    w[k] += (st[k] * err) >> 10;
+                uint16_t& t = a[wt >> 6];
+                t = uint16_t(t + (((bit ? 65535 : 0) - int(t)) >> kCmApmRate));
+
+                c0 = c0 * 2 + bit;
+                nib = nib * 2 + bit;
+            }
+            vals[i] = (vals[i] & ~(255u << shift)) | ((c0 & 255) << shift);
+        }
+    }
+}
+
+static size_t CmEncodeBand(const float* src, int width, int channels, const CmBand& b, CmModel& m, int tableBits, uint8_t* dst)
+{
+    m.Reset(tableBits);
+    std::vector<uint8_t> out;
+    CmEncoder coder(out);
+    std::vector<uint32_t> vals(b.count);
+    const uint32_t* srcInt = (const uint32_t*)src + b.start * channels;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        for (size_t i = 0; i < b.count; ++i)
+            vals[i] = srcInt[i * channels + ch];
+        CmCodeChannel(m, coder, vals.data(), b.count, width, ch);
+    }
+    coder.Flush();
+
+    const size_t rawSize = b.count * channels * 4;
+    if (out.size() >= rawSize)
+    {
+        memcpy(dst, srcInt, rawSize);
+        return rawSize;
+    }
+    memcpy(dst, out.data(), out.size());
+    return out.size();
+}
+
+static void CmDecodeBand(const uint8_t* src, size_t srcSize, float* dst, int width, int channels, const CmBand& b, CmModel& m, int tableBits)
+{
+    uint32_t* dstInt = (uint32_t*)dst + b.start * channels;
+    const size_t rawSize = b.count * channels * 4;
+    if (srcSize == rawSize)
+    {
+        memcpy(dstInt, src, rawSize);
+        return;
+    }
+    m.Reset(tableBits);
+    CmDecoder coder(src, srcSize);
+    std::vector<uint32_t> vals(b.count);
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        std::fill(vals.begin(), vals.end(), 0);
+        CmCodeChannel(m, coder, vals.data(), b.count, width, ch);
+        for (size_t i = 0; i < b.count; ++i)
+            dstInt[i * channels + ch] = vals[i];
+    }
+}
+
+// bands coded in parallel, each with its own model; as many as fit into memory budget
+static int CmGetThreadCount(int threadCount, int bandCount, int tableBits)
+{
+    if (threadCount <= 0)
+        threadCount = GetHardwareThreadCount();
+    const int fitting = int(std::max<size_t>(1, kCmMemoryBudget / CmModel::GetMemorySize(tableBits)));
+    return std::max(1, std::min({ threadCount, bandCount, fitting }));
+}
+
+size_t cm_compress_bound(int width, int height, int channels)
+{
+    return sizeof(CmHeader) + CmBandCount(width, height) * 4 + size_t(width) * height * channels * 4;
+}
+
+size_t cm_compress(const float* src, int width, int height, int channels, int level, int threadCount, uint8_t* dst)
+{
+    int tableBits = 18 + 2 * std::clamp(level, 0, 2);
+    while (tableBits > kCmMinTableBits && CmModel::GetMemorySize(tableBits) > kCmMemoryBudget)
+        --tableBits;
+    const int bandCount = CmBandCount(width, height);
+    CmHeader* hdr = (CmHeader*)dst;
+    hdr->tableBits = tableBits;
+    hdr->bandCount = bandCount;
+    uint32_t* bandSizes = (uint32_t*)(dst + sizeof(CmHeader));
+
+    std::vector<size_t> tmpOffsets(bandCount + 1, 0);
+    for (int ib = 0; ib < bandCount; ++ib)
+        tmpOffsets[ib + 1] = tmpOffsets[ib] + CmGetBand(width, height, ib).count * channels * 4;
+    std::vector<uint8_t> tmp(tmpOffsets[bandCount]);
+    threadCount = CmGetThreadCount(threadCount, bandCount, tableBits);
+    std::vector<CmModel> models(threadCount);
+    ParallelFor(bandCount, threadCount, [&](int ib, int thread)
+    {
+        bandSizes[ib] = uint32_t(CmEncodeBand(src, width, channels, CmGetBand(width, height, ib), models[thread], tableBits, tmp.data() + tmpOffsets[ib]));
+    });
+
+    uint8_t* out = dst + sizeof(CmHeader) + bandCount * 4;
+    for (int ib = 0; ib < bandCount; ++ib)
+    {
+        memcpy(out, tmp.data() + tmpOffsets[ib], bandSizes[ib]);
+        out += bandSizes[ib];
+    }
+    return out - dst;
+}
+
+void cm_decompress(const uint8_t* src, size_t srcSize, float* dst, int width, int height, int channels, int threadCount)
+{
+    const CmHeader* hdr = (const CmHeader*)src;
+    const int bandCount = hdr->bandCount;
+    const int tableBits = hdr->tableBits;
+    const uint32_t* bandSizes = (const uint32_t*)(src + sizeof(CmHeader));
+    std::vector<size_t> bandOffsets(bandCount);
+    size_t offset = sizeof(CmHeader) + bandCount * 4;
+    for (int ib = 0; ib < bandCount; ++ib)
+    {
+        bandOffsets[ib] = offset;
+        offset += bandSizes[ib];
+    }
+    threadCount = CmGetThreadCount(threadCount, bandCount, tableBits);
+    std::vector<CmModel> models(threadCount);
+    ParallelFor(bandCount, threadCount, [&](int ib, int thread)
+    {
+        CmDecodeBand(src + bandOffsets[ib], bandSizes[ib], dst, width, channels, CmGetBand(width, height, ib), models[thread], tableBits);
+    });
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Slow, high ratio lossless codec: bitwise context mixing (PAQ / lpaq style) over the byte
+// planes of float32 bit patterns. Each channel of interleaved data is coded separately,
+// byte plane by byte plane starting from the highest (sign + exponent) one. Every bit is
+// predicted by several context models (same byte of the previous element, of the element in
+// the row above, of a Lorenzo predicted value, and the already coded higher byte planes of
+// the current element), predictions are combined by a gated linear mixer, refined by an
+// APM / SSE stage and arithmetic coded.
+// Data is coded in independent bands of rows (1D data: ranges of elements) that run in
+// parallel; models of all the bands in flight share a fixed memory budget, which limits
+// model table size (level 0..2 picks 2^18..2^22 counters per context) and thread count.
+size_t cm_compress_bound(int width, int height, int channels);
+size_t cm_compress(const float* src, int width, int height, int channels, int level, int threadCount, uint8_t* dst);
+void cm_decompress(const uint8_t* src, size_t srcSize, float* dst, int width, int height, int channels, int threadCount);
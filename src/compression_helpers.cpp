@@ -15,6 +15,8 @@
 #include "../libs/lzsse/lzsse8/lzsse8.h"
 #include "../libs/lizard/lizard_compress.h"
 #include "../libs/lizard/lizard_decompress.h"
+#include "rans.h"
+#include "../libs/lizard/entropy/huf.h"
 
 #if BUILD_WITH_OODLE
 #include "oodle_wrapper.h"
@@ -33,11 +35,104 @@ int decompress_meshopt_vertex_attribute(const void* src, size_t srcSize, int ver
 	return meshopt_decodeVertexBuffer(dst, vertexCount, vertexSize, (const unsigned char*)src, srcSize);
 }
 
+void meshopt_filter_encode(MeshOptFilter filter, void* dst, size_t count, size_t stride, int bits, const float* src)
+{
+	switch (filter)
+	{
+	case kMeshOptFilterExp: meshopt_encodeFilterExp(dst, count, stride, bits, src); break;
+	case kMeshOptFilterQuat: meshopt_encodeFilterQuat(dst, count, stride, bits, src); break;
+	case kMeshOptFilterOct: meshopt_encodeFilterOct(dst, count, stride, bits, src); break;
+	}
+}
+void meshopt_filter_decode(MeshOptFilter filter, void* buffer, size_t count, size_t stride)
+{
+	switch (filter)
+	{
+	case kMeshOptFilterExp: meshopt_decodeFilterExp(buffer, count, stride); break;
+	case kMeshOptFilterQuat: meshopt_decodeFilterQuat(buffer, count, stride); break;
+	case kMeshOptFilterOct: meshopt_decodeFilterOct(buffer, count, stride); break;
+	}
+}
+
 void meshopt_get_version(size_t bufSize, char* buf)
 {
 	snprintf(buf, bufSize, "meshopt-%i.%i", MESHOPTIMIZER_VERSION/1000, (MESHOPTIMIZER_VERSION/10)%1000);
 }
 
+// Huff0 on byte planes: input is `planes` contiguous planes, each coded as chunks of up
+// to HUF_BLOCKSIZE_MAX bytes. Chunk stream is prefixed by its size; size equal to chunk
+// size means stored raw, size 1 means a constant (RLE) chunk, like HUF_decompress expects.
+struct HufPlanesHeader
+{
+	uint32_t size;
+	uint32_t planes;
+};
+
+static size_t huf_planes_calc_bound(size_t srcSize)
+{
+	size_t chunks = (srcSize + HUF_BLOCKSIZE_MAX - 1) / HUF_BLOCKSIZE_MAX + 64;
+	return sizeof(HufPlanesHeader) + srcSize + chunks * 4;
+}
+
+static size_t compress_huf_planes(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize, int planes)
+{
+	if (planes < 1 || planes > 64 || srcSize < size_t(planes))
+		planes = 1;
+	HufPlanesHeader* hdr = (HufPlanesHeader*)dst;
+	hdr->size = uint32_t(srcSize);
+	hdr->planes = uint32_t(planes);
+	uint8_t* out = dst + sizeof(HufPlanesHeader);
+	const uint8_t* outEnd = dst + dstSize;
+	const size_t planeSize = srcSize / planes;
+	for (int ip = 0; ip < planes; ++ip)
+	{
+		const uint8_t* ps = src + ip * planeSize;
+		size_t count = ip == planes - 1 ? srcSize - ip * planeSize : planeSize;
+		for (size_t start = 0; start < count; start += HUF_BLOCKSIZE_MAX)
+		{
+			size_t chunk = count - start < HUF_BLOCKSIZE_MAX ? count - start : HUF_BLOCKSIZE_MAX;
+			size_t size = HUF_compress(out + 4, outEnd - out - 4, ps + start, chunk);
+			if (size == 1)
+				out[4] = ps[start]; // RLE
+			else if (HUF_isError(size) || size == 0 || size >= chunk)
+			{
+				size = chunk; // not compressible: stored
+				memcpy(out + 4, ps + start, chunk);
+			}
+			uint32_t size32 = uint32_t(size);
+			memcpy(out, &size32, 4);
+			out += 4 + size;
+		}
+	}
+	return out - dst;
+}
+
+static size_t decompress_huf_planes(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+	const HufPlanesHeader* hdr = (const HufPlanesHeader*)src;
+	const size_t size = hdr->size;
+	const int planes = int(hdr->planes);
+	if (size > dstSize)
+		return 0;
+	const uint8_t* in = src + sizeof(HufPlanesHeader);
+	const size_t planeSize = size / planes;
+	for (int ip = 0; ip < planes; ++ip)
+	{
+		uint8_t* pd = dst + ip * planeSize;
+		size_t count = ip == planes - 1 ? size - ip * planeSize : planeSize;
+		for (size_t start = 0; start < count; start += HUF_BLOCKSIZE_MAX)
+		{
+			size_t chunk = count - start < HUF_BLOCKSIZE_MAX ? count - start : HUF_BLOCKSIZE_MAX;
+			uint32_t cmpSize;
+			memcpy(&cmpSize, in, 4);
+			size_t res = HUF_decompress(pd + start, chunk, in + 4, cmpSize);
+			if (HUF_isError(res))
+				return 0;
+			in += 4 + cmpSize;
+		}
+	}
+	return size;
+}
 
 size_t compress_calc_bound(size_t srcSize, CompressionFormat format)
 {
@@ -72,7 +167,13 @@ size_t compress_calc_bound(size_t srcSize, CompressionFormat format)
     case kCompressionLZSSE8: return srcSize;
 	case kCompressionLizard1x:
 	case kCompressionLizard2x:
+	case kCompressionLizard3x:
+	case kCompressionLizard4x:
+	case kCompressionLizard1x_Stride:
+	case kCompressionLizard2x_Stride:
 		return Lizard_compressBound(int(srcSize));
+	case kCompressionRans: return rans_compress_bound(srcSize);
+	case kCompressionHuff0: return huf_planes_calc_bound(srcSize);
 #	if BUILD_WITH_OODLE
 	case kCompressionOoodleSelkie:
 	case kCompressionOoodleMermaid:
@@ -184,7 +285,14 @@ size_t compress_data(const void* src, size_t srcSize, void* dst, size_t dstSize,
     }
 	case kCompressionLizard1x:
 	case kCompressionLizard2x:
+	case kCompressionLizard3x:
+	case kCompressionLizard4x:
 		return Lizard_compress((const char*)src, (char*)dst, (int)srcSize, (int)dstSize, level);
+	case kCompressionLizard1x_Stride:
+	case kCompressionLizard2x_Stride:
+		return Lizard_compress_stride((const char*)src, (char*)dst, (int)srcSize, (int)dstSize, level, stride);
+	case kCompressionRans: return rans_compress((const uint8_t*)src, srcSize, (uint8_t*)dst, dstSize, stride);
+	case kCompressionHuff0: return compress_huf_planes((const uint8_t*)src, srcSize, (uint8_t*)dst, dstSize, stride);
 #	if BUILD_WITH_OODLE
 	case kCompressionOoodleSelkie:
 	case kCompressionOoodleMermaid:
@@ -250,7 +358,13 @@ size_t decompress_data(const void* src, size_t srcSize, void* dst, size_t dstSiz
     case kCompressionLZSSE8: return LZSSE8_Decompress(src, srcSize, dst, dstSize);
 	case kCompressionLizard1x:
 	case kCompressionLizard2x:
+	case kCompressionLizard3x:
+	case kCompressionLizard4x:
+	case kCompressionLizard1x_Stride:
+	case kCompressionLizard2x_Stride:
 		return Lizard_decompress_safe((const char*)src, (char*)dst, (int)srcSize, (int)dstSize);
+	case kCompressionRans: return rans_decompress((const uint8_t*)src, srcSize, (uint8_t*)dst, dstSize);
+	case kCompressionHuff0: return decompress_huf_planes((const uint8_t*)src, srcSize, (uint8_t*)dst, dstSize);
 #	if BUILD_WITH_OODLE
 	case kCompressionOoodleSelkie:
 	case kCompressionOoodleMermaid:
@@ -286,7 +400,13 @@ void compressor_get_version(CompressionFormat format, size_t bufSize, char* buf)
     case kCompressionLZSSE8: snprintf(buf, bufSize, "lzsse8-2019"); break;
 	case kCompressionLizard1x:
 	case kCompressionLizard2x:
+	case kCompressionLizard3x:
+	case kCompressionLizard4x:
+	case kCompressionLizard1x_Stride:
+	case kCompressionLizard2x_Stride:
 		snprintf(buf, bufSize, "lizard-%i.%i", LIZARD_VERSION_MAJOR, LIZARD_VERSION_MINOR); break;
+	case kCompressionRans: snprintf(buf, bufSize, "rans-16x"); break;
+	case kCompressionHuff0: snprintf(buf, bufSize, "huf0-zstd-%s", ZSTD_versionString()); break;
 
 #	if BUILD_WITH_OODLE
 	case kCompressionOoodleSelkie:
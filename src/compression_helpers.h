@@ -8,6 +8,17 @@ size_t compress_meshopt_vertex_attribute_bound(int vertexCount, int vertexSize);
 size_t compress_meshopt_vertex_attribute(const void* src, int vertexCount, int vertexSize, void* dst, size_t dstSize);
 int decompress_meshopt_vertex_attribute(const void* src, size_t srcSize, int vertexCount, int vertexSize, void* dst);
 void meshopt_get_version(size_t bufSize, char* buf);
+// mesh optimizer attribute filters (lossy), decoding works in place. Exp: any float vectors,
+// stride = 4*floats; Quat: unit quaternions (4 floats) to 4x int16; Oct: unit vectors + w
+// (4 floats) to 4x int16.
+enum MeshOptFilter
+{
+	kMeshOptFilterExp,
+	kMeshOptFilterQuat,
+	kMeshOptFilterOct,
+};
+void meshopt_filter_encode(MeshOptFilter filter, void* dst, size_t count, size_t stride, int bits, const float* src);
+void meshopt_filter_decode(MeshOptFilter filter, void* buffer, size_t count, size_t stride);
 
 // generic lossless compressors
 enum CompressionFormat
@@ -35,6 +46,12 @@ enum CompressionFormat
     kCompressionLZSSE8,
 	kCompressionLizard1x,
 	kCompressionLizard2x,
+	kCompressionLizard3x,
+	kCompressionLizard4x,
+	kCompressionLizard1x_Stride,
+	kCompressionLizard2x_Stride,
+	kCompressionRans,
+	kCompressionHuff0,
 	kCompressionCount
 };
 size_t compress_calc_bound(size_t srcSize, CompressionFormat format);
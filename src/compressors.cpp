@@ -1,10 +1,14 @@
 #include "compressors.h"
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
+#include <math.h>
 
 #include <fpzip.h>
 #include <zfp.h>
 #include "../libs/spdp/spdp_11.h"
+#include "spdp_mt.h"
+#include "pfor.h"
 #include "../libs/sokol_time.h"
 
 #if BUILD_WITH_NDZIP
@@ -14,9 +18,22 @@
 #include <streamvbyte.h>
 #include <streamvbytedelta.h>
 
+#include <lz4.h>
+#include <lz4hc.h>
+#include "../libs/lzsse/lzsse8/lzsse8.h"
+
 #include <string>
+#include <set>
+#include <algorithm>
 
 #include "simd.h"
+#include "parallel.h"
+#include "chimp.h"
+#include "alp.h"
+#include "fpc.h"
+#include "sz.h"
+#include "cm.h"
+#include "filters.h"
 
 
 static std::vector<int> GetGenericLevelRange(CompressionFormat format)
@@ -65,15 +82,21 @@ static std::vector<int> GetGenericLevelRange(CompressionFormat format)
     case kCompressionLZSSE8:
         return { 0, 1, 2, 3, 4, 5 }; // only 0, 1 keeps comp time under 3s
     case kCompressionLizard1x:
+    case kCompressionLizard1x_Stride:
         return { 10, 11, 12, 13, 14, 16 };
     case kCompressionLizard2x:
+    case kCompressionLizard2x_Stride:
         return { 20, 21, 22, 23, 24, 26 };
+    case kCompressionLizard3x:
+        return { 30, 31, 32, 33, 34, 36 };
+    case kCompressionLizard4x:
+        return { 40, 41, 42, 43, 44, 46 };
     default:
         return { 0 };
     }
 }
 
-std::vector<int> SpdpCompressor::GetLevels() const { return {0, 3, 6, 9}; }
+std::vector<int> SpdpCompressor::GetLevels() const { return {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}; }
 
 
 template<typename T>
@@ -106,10 +129,162 @@ static void UnSplit(const T* src, T* dst, int channels, int planeElems)
     }
 }
 
+// Plane bypass: a sample of the plane is checked for both order-0 entropy and for LZ matches
+// (by compressing it with fast LZ4). Codecs without entropy coding only gain from matches;
+// the others can also gain from a skewed histogram.
+const size_t kPlaneSamplePiece = 4096;
+const size_t kPlaneSamplePieces = 4;
+const double kPlaneBypassEntropy = 7.9;
+const double kPlaneBypassMinRatio = 1.03;
+
+static bool HasEntropyCoding(CompressionFormat format)
+{
+    switch (format)
+    {
+    case kCompressionLZ4:
+    case kCompressionBloscBLZ:
+    case kCompressionBloscLZ4:
+    case kCompressionBloscBLZ_Shuf:
+    case kCompressionBloscLZ4_Shuf:
+    case kCompressionBloscBLZ_ShufDelta:
+    case kCompressionBloscLZ4_ShufDelta:
+    case kCompressionBloscBLZ_ShufByteDelta:
+    case kCompressionBloscLZ4_ShufByteDelta:
+    case kCompressionLZSSE8:
+    case kCompressionLizard1x:
+    case kCompressionLizard2x:
+    case kCompressionLizard1x_Stride:
+    case kCompressionLizard2x_Stride:
+        return false;
+    default:
+        return true;
+    }
+}
+
+static bool IsPlaneIncompressible(const uint8_t* data, size_t size, CompressionFormat format)
+{
+    // evenly spaced pieces of the plane
+    uint8_t sample[kPlaneSamplePiece * kPlaneSamplePieces];
+    const size_t sampleSize = std::min(size, sizeof(sample));
+    if (sampleSize == 0)
+        return false;
+    if (size <= sizeof(sample))
+        memcpy(sample, data, size);
+    else
+    {
+        const size_t step = (size - kPlaneSamplePiece) / (kPlaneSamplePieces - 1);
+        for (size_t p = 0; p < kPlaneSamplePieces; ++p)
+            memcpy(sample + p * kPlaneSamplePiece, data + p * step, kPlaneSamplePiece);
+    }
+
+    if (HasEntropyCoding(format))
+    {
+        uint32_t hist[256] = {};
+        for (size_t i = 0; i < sampleSize; ++i)
+            hist[sample[i]]++;
+        double entropy = 0.0;
+        for (int i = 0; i < 256; ++i)
+        {
+            if (hist[i] == 0)
+                continue;
+            double p = double(hist[i]) / sampleSize;
+            entropy -= p * log2(p);
+        }
+        if (entropy < kPlaneBypassEntropy)
+            return false;
+    }
+
+    char cmp[LZ4_COMPRESSBOUND(sizeof(sample))];
+    int cmpSize = LZ4_compress_default((const char*)sample, cmp, int(sampleSize), sizeof(cmp));
+    return cmpSize == 0 || sampleSize < cmpSize * kPlaneBypassMinRatio;
+}
+
+// Plane bypass format: u64 mask of raw planes (planes past 64 always use the codec), then for
+// each run of planes of the same kind: raw plane bytes, or u32 compressed size + compressed
+// data of the whole run.
+static bool IsRawPlane(uint64_t rawMask, int plane)
+{
+    return plane < 64 && ((rawMask >> plane) & 1) != 0;
+}
+
+static size_t CompressPlaneBypass(const uint8_t* src, size_t planeSize, int planes, uint8_t* dst, size_t dstSize, CompressionFormat format, int level)
+{
+    uint64_t rawMask = 0;
+    for (int ip = 0; ip < planes && ip < 64; ++ip)
+    {
+        if (IsPlaneIncompressible(src + ip * planeSize, planeSize, format))
+            rawMask |= 1ull << ip;
+    }
+    memcpy(dst, &rawMask, 8);
+    uint8_t* out = dst + 8;
+    for (int ip = 0; ip < planes; )
+    {
+        const bool raw = IsRawPlane(rawMask, ip);
+        int run = 1;
+        while (ip + run < planes && IsRawPlane(rawMask, ip + run) == raw)
+            ++run;
+        const size_t runSize = planeSize * run;
+        if (raw)
+        {
+            memcpy(out, src + ip * planeSize, runSize);
+            out += runSize;
+        }
+        else
+        {
+            // rans / huff0 take the number of planes in the run as stride and code each plane
+            // with its own model; for the others (blosc typesize, Lizard stride) the run is
+            // already split into planes, so it is plain byte data.
+            const int stride = (format == kCompressionRans || format == kCompressionHuff0) ? run : 1;
+            uint32_t size = uint32_t(compress_data(src + ip * planeSize, runSize, out + 4, dstSize - (out + 4 - dst), format, level, stride));
+            memcpy(out, &size, 4);
+            out += 4 + size;
+        }
+        ip += run;
+    }
+    return out - dst;
+}
+
+static void DecompressPlaneBypass(const uint8_t* src, uint8_t* dst, size_t planeSize, int planes, CompressionFormat format)
+{
+    uint64_t rawMask;
+    memcpy(&rawMask, src, 8);
+    src += 8;
+    for (int ip = 0; ip < planes; )
+    {
+        const bool raw = IsRawPlane(rawMask, ip);
+        int run = 1;
+        while (ip + run < planes && IsRawPlane(rawMask, ip + run) == raw)
+            ++run;
+        const size_t runSize = planeSize * run;
+        if (raw)
+        {
+            memcpy(dst + ip * planeSize, src, runSize);
+            src += runSize;
+        }
+        else
+        {
+            uint32_t size;
+            memcpy(&size, src, 4);
+            decompress_data(src + 4, size, dst + ip * planeSize, runSize, format);
+            src += 4 + size;
+        }
+        ip += run;
+    }
+}
+
 uint8_t* GenericCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
 {
     size_t dataSize = width * height * channels * sizeof(float);
     size_t bound = compress_calc_bound(dataSize, m_Format);
+    if (m_PlaneBypass)
+    {
+        // raw planes never grow, and each run of codec planes is within the sum of plane bounds
+        const int planes = channels * sizeof(float);
+        bound = 8 + planes * (4 + compress_calc_bound(width * height, m_Format));
+        uint8_t* cmp = new uint8_t[bound];
+        outSize = CompressPlaneBypass((const uint8_t*)data, width * height, planes, cmp, bound, m_Format, level);
+        return cmp;
+    }
     uint8_t* cmp = new uint8_t[bound];
     outSize = compress_data(data, dataSize, cmp, bound, m_Format, level, channels * sizeof(float));
     return cmp;
@@ -118,6 +293,11 @@ uint8_t* GenericCompressor::Compress(int level, const float* data, int width, in
 void GenericCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
 {
     size_t dataSize = width * height * channels * sizeof(float);
+    if (m_PlaneBypass)
+    {
+        DecompressPlaneBypass(cmp, (uint8_t*)data, width * height, channels * sizeof(float), m_Format);
+        return;
+    }
     decompress_data(cmp, cmpSize, data, dataSize, m_Format);
 }
 
@@ -145,12 +325,18 @@ static const char* kCompressionFormatNames[] = {
     "lzsse8",
     "lizard1x",
     "lizard2x",
+    "lizard3x",
+    "lizard4x",
+    "lizard1x-st",
+    "lizard2x-st",
+    "rans",
+    "huf0",
 };
 static_assert(sizeof(kCompressionFormatNames) / sizeof(kCompressionFormatNames[0]) == kCompressionCount);
 
 void GenericCompressor::PrintName(size_t bufSize, char* buf) const
 {
-    snprintf(buf, bufSize, "%s", kCompressionFormatNames[m_Format]);
+    snprintf(buf, bufSize, "%s%s", kCompressionFormatNames[m_Format], m_PlaneBypass ? "-byp" : "");
 }
 
 void GenericCompressor::PrintVersion(size_t bufSize, char* buf) const
@@ -191,6 +377,81 @@ static uint8_t* DecompressGeneric(CompressionFormat format, const uint8_t* cmp,
     return decomp;
 }
 
+// Row band chunking, for codecs that work on whole images: bands of chunkRows rows (1D data:
+// runs of chunkRows*1024 elements) are compressed independently, chunkFunc(data, width, height,
+// channels, outSize) on multiple threads. Output: u32 chunk rows, u32 chunk count, u32 compressed
+// size of each chunk, chunk data.
+static int GetChunkCount(int width, int height, int chunkRows)
+{
+    if (height == 1)
+        return (width + chunkRows * 1024 - 1) / (chunkRows * 1024);
+    return (height + chunkRows - 1) / chunkRows;
+}
+
+static size_t GetChunkExtent(int width, int height, int chunkRows, int index, int& chunkWidth, int& chunkHeight)
+{
+    if (height == 1)
+    {
+        int chunkElems = chunkRows * 1024;
+        chunkWidth = std::min(chunkElems, width - index * chunkElems);
+        chunkHeight = 1;
+        return size_t(index) * chunkElems;
+    }
+    chunkWidth = width;
+    chunkHeight = std::min(chunkRows, height - index * chunkRows);
+    return size_t(index) * chunkRows * width;
+}
+
+template<typename ChunkFunc>
+static uint8_t* CompressChunked(const float* data, int width, int height, int channels, int chunkRows, int threadCount, size_t& outSize, ChunkFunc chunkFunc)
+{
+    int chunkCount = GetChunkCount(width, height, chunkRows);
+    std::vector<uint8_t*> chunks(chunkCount);
+    std::vector<size_t> chunkSizes(chunkCount);
+    ParallelFor(chunkCount, threadCount, [&](int index, int)
+    {
+        int chunkWidth, chunkHeight;
+        size_t start = GetChunkExtent(width, height, chunkRows, index, chunkWidth, chunkHeight);
+        chunks[index] = chunkFunc(data + start * channels, chunkWidth, chunkHeight, channels, chunkSizes[index]);
+    });
+
+    size_t headerSize = (2 + chunkCount) * sizeof(uint32_t);
+    outSize = headerSize;
+    for (size_t size : chunkSizes)
+        outSize += size;
+    uint8_t* cmp = new uint8_t[outSize];
+    uint32_t* header = (uint32_t*)cmp;
+    header[0] = chunkRows;
+    header[1] = chunkCount;
+    uint8_t* dst = cmp + headerSize;
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        header[2 + i] = uint32_t(chunkSizes[i]);
+        memcpy(dst, chunks[i], chunkSizes[i]);
+        dst += chunkSizes[i];
+        delete[] chunks[i];
+    }
+    return cmp;
+}
+
+template<typename ChunkFunc>
+static void DecompressChunked(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels, int threadCount, ChunkFunc chunkFunc)
+{
+    const uint32_t* header = (const uint32_t*)cmp;
+    int chunkRows = header[0];
+    int chunkCount = header[1];
+    std::vector<size_t> chunkOffsets(chunkCount + 1);
+    chunkOffsets[0] = (2 + chunkCount) * sizeof(uint32_t);
+    for (int i = 0; i < chunkCount; ++i)
+        chunkOffsets[i + 1] = chunkOffsets[i] + header[2 + i];
+    ParallelFor(chunkCount, threadCount, [&](int index, int)
+    {
+        int chunkWidth, chunkHeight;
+        size_t start = GetChunkExtent(width, height, chunkRows, index, chunkWidth, chunkHeight);
+        chunkFunc(cmp + chunkOffsets[index], chunkOffsets[index + 1] - chunkOffsets[index], data + start * channels, chunkWidth, chunkHeight, channels);
+    });
+}
+
 uint8_t* MeshOptCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
 {
     int stride = channels * sizeof(float);
@@ -235,7 +496,7 @@ void MeshOptCompressor::PrintVersion(size_t bufSize, char* buf) const
 }
 
 
-uint8_t* FpzipCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+static uint8_t* FpzipCompressImage(const float* data, int width, int height, int channels, size_t& outSize)
 {
     // without split-by-float, fpzip only achieves ~1.5x ratio;
     // with split it gets to 3.8x.
@@ -259,7 +520,7 @@ uint8_t* FpzipCompressor::Compress(int level, const float* data, int width, int
     return cmp;
 }
 
-void FpzipCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+static void FpzipDecompressImage(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
 {
     uint32_t* split = new uint32_t[width * height * channels];
     
@@ -276,9 +537,39 @@ void FpzipCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data
     delete[] split;
 }
 
+uint8_t* FpzipCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    if (m_ChunkRows == 0)
+        return FpzipCompressImage(data, width, height, channels, outSize);
+    return CompressChunked(data, width, height, channels, m_ChunkRows, m_ThreadCount, outSize, FpzipCompressImage);
+}
+
+void FpzipCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    if (m_ChunkRows == 0)
+        FpzipDecompressImage(cmp, cmpSize, data, width, height, channels);
+    else
+        DecompressChunked(cmp, cmpSize, data, width, height, channels, m_ThreadCount, FpzipDecompressImage);
+}
+
+// "-b<rows>" for chunked variants, plus "-t<threads>" ("-mt": all threads)
+static void PrintChunkedSuffix(size_t bufSize, char* buf, int chunkRows, int threadCount)
+{
+    buf[0] = 0;
+    int len = 0;
+    if (chunkRows != 0)
+        len = snprintf(buf, bufSize, "-b%i", chunkRows);
+    if (threadCount == 0)
+        snprintf(buf + len, bufSize - len, "-mt");
+    else if (threadCount > 1)
+        snprintf(buf + len, bufSize - len, "-t%i", threadCount);
+}
+
 void FpzipCompressor::PrintName(size_t bufSize, char* buf) const
 {
-    snprintf(buf, bufSize, "fpzip-ls");
+    char suffix[40];
+    PrintChunkedSuffix(sizeof(suffix), suffix, m_ChunkRows, m_ThreadCount);
+    snprintf(buf, bufSize, "fpzip-ls%s", suffix);
 }
 
 void FpzipCompressor::PrintVersion(size_t bufSize, char* buf) const
@@ -286,31 +577,75 @@ void FpzipCompressor::PrintVersion(size_t bufSize, char* buf) const
     snprintf(buf, bufSize, "fpz-%i.%i", FPZIP_VERSION_MAJOR, FPZIP_VERSION_MINOR);
 }
 
-uint8_t* ZfpCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+// lossy modes: level -> zfp stream parameters
+static void ZfpSetMode(zfp_stream* zfp, const zfp_field* field, ZfpMode mode, int level)
+{
+    switch (mode)
+    {
+    case kZfpReversible: zfp_stream_set_reversible(zfp); break;
+    case kZfpAccuracy: zfp_stream_set_accuracy(zfp, pow(10.0, -level)); break;
+    case kZfpPrecision: zfp_stream_set_precision(zfp, level); break;
+    case kZfpRate: zfp_stream_set_rate(zfp, level, zfp_type_float, zfp_field_dimensionality(field), 0); break;
+    }
+}
+
+// zfp field over interleaved data: either one channel (strided), or all the channels
+// as the last dimension (1D data -> 2D field, 2D data -> 3D field)
+static zfp_field ZfpMakeField(const float* data, int width, int height, int channels, bool channelDim)
 {
     zfp_field field = {};
     field.type = zfp_type_float;
+    field.data = (void*)data;
     field.nx = width;
-    field.ny = height == 1 ? 0 : height; // note: for 1D data, tell zfp to explicitly treat data as one-dimensional
     field.sx = channels;
-    field.sy = channels * width;
+    if (height == 1)
+    {
+        // note: for 1D data, tell zfp to explicitly treat data as one-dimensional
+        if (channelDim)
+        {
+            field.ny = channels;
+            field.sy = 1;
+        }
+    }
+    else
+    {
+        field.ny = height;
+        field.sy = channels * width;
+        if (channelDim)
+        {
+            field.nz = channels;
+            field.sz = 1;
+        }
+    }
+    return field;
+}
 
+// compresses fieldCount fields (each next one starting one float later) into one zfp stream
+static uint8_t* ZfpCompressFields(zfp_field field, int fieldCount, ZfpMode mode, int level, int ompThreads, size_t& outSize)
+{
     zfp_stream* zfp = zfp_stream_open(NULL);
-    zfp_stream_set_reversible(zfp);
-    //const float kAccuracy = 0.1f;
-    //zfp_stream_set_accuracy(zfp, kAccuracy);
+    ZfpSetMode(zfp, &field, mode, level);
+    // zfp only has OpenMP compression (decompression is always serial); stays serial
+    // if zfp was built without OpenMP
+    if (ompThreads != 1 && zfp_stream_set_execution(zfp, zfp_exec_omp))
+        zfp_stream_set_omp_threads(zfp, ompThreads);
 
-    size_t bound = zfp_stream_maximum_size(zfp, &field) * channels;
+    size_t bound = zfp_stream_maximum_size(zfp, &field) * fieldCount;
     uint8_t* cmp = new uint8_t[bound];
 
     bitstream* stream = stream_open(cmp, bound);
     zfp_stream_set_bit_stream(zfp, stream);
     zfp_stream_rewind(zfp);
 
+    // lossy modes store compression parameters in a zfp header, since level is not known at decompression
+    if (mode != kZfpReversible)
+        zfp_write_header(zfp, &field, ZFP_HEADER_MODE);
+
     outSize = 0;
-    for (int ich = 0; ich < channels; ++ich)
+    const float* data = (const float*)field.data;
+    for (int i = 0; i < fieldCount; ++i)
     {
-        field.data = (void*)(data + ich);
+        field.data = (void*)(data + i);
         outSize = zfp_compress(zfp, &field); // note: returns cumulative bytes of whole storage
     }
     stream_close(stream);
@@ -318,31 +653,111 @@ uint8_t* ZfpCompressor::Compress(int level, const float* data, int width, int he
     return cmp;
 }
 
-void ZfpCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+static void ZfpDecompressFields(zfp_field field, int fieldCount, ZfpMode mode, const uint8_t* cmp, size_t cmpSize)
 {
-    zfp_field field = {};
-    field.type = zfp_type_float;
-    field.nx = width;
-    field.ny = height == 1 ? 0 : height; // note: for 1D data, tell zfp to explicitly treat data as one-dimensional
-    field.sx = channels;
-    field.sy = channels * width;
     zfp_stream* zfp = zfp_stream_open(NULL);
     zfp_stream_set_reversible(zfp);
     bitstream* stream = stream_open((void*)cmp, cmpSize);
     zfp_stream_set_bit_stream(zfp, stream);
     zfp_stream_rewind(zfp);
-    for (int ich = 0; ich < channels; ++ich)
+    if (mode != kZfpReversible)
+        zfp_read_header(zfp, &field, ZFP_HEADER_MODE);
+    float* data = (float*)field.data;
+    for (int i = 0; i < fieldCount; ++i)
     {
-        field.data = (void*)(data + ich);
+        field.data = (void*)(data + i);
         zfp_decompress(zfp, &field);
     }
     stream_close(stream);
     zfp_stream_close(zfp);
 }
 
+uint8_t* ZfpCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    if (m_Layout == kZfpLayoutStrided)
+        return ZfpCompressFields(ZfpMakeField(data, width, height, channels, false), channels, m_Mode, level, m_ThreadCount, outSize);
+    if (m_Layout == kZfpLayoutChannelDim)
+        return ZfpCompressFields(ZfpMakeField(data, width, height, channels, true), 1, m_Mode, level, m_ThreadCount, outSize);
+
+    // planes: each channel into a separate stream, in parallel; prefixed by sizes of them
+    std::vector<uint8_t*> planes(channels);
+    std::vector<size_t> planeSizes(channels);
+    ParallelFor(channels, m_ThreadCount, [&](int ch, int)
+    {
+        planes[ch] = ZfpCompressFields(ZfpMakeField(data + ch, width, height, channels, false), 1, m_Mode, level, 1, planeSizes[ch]);
+    });
+    outSize = channels * sizeof(uint32_t);
+    for (int ch = 0; ch < channels; ++ch)
+        outSize += planeSizes[ch];
+    uint8_t* cmp = new uint8_t[outSize];
+    uint8_t* dst = cmp + channels * sizeof(uint32_t);
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        uint32_t size = uint32_t(planeSizes[ch]);
+        memcpy(cmp + ch * sizeof(uint32_t), &size, sizeof(size));
+        memcpy(dst, planes[ch], planeSizes[ch]);
+        dst += planeSizes[ch];
+        delete[] planes[ch];
+    }
+    return cmp;
+}
+
+void ZfpCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    if (m_Layout == kZfpLayoutStrided)
+    {
+        ZfpDecompressFields(ZfpMakeField(data, width, height, channels, false), channels, m_Mode, cmp, cmpSize);
+        return;
+    }
+    if (m_Layout == kZfpLayoutChannelDim)
+    {
+        ZfpDecompressFields(ZfpMakeField(data, width, height, channels, true), 1, m_Mode, cmp, cmpSize);
+        return;
+    }
+
+    std::vector<size_t> planeOffsets(channels + 1);
+    planeOffsets[0] = channels * sizeof(uint32_t);
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        uint32_t size;
+        memcpy(&size, cmp + ch * sizeof(uint32_t), sizeof(size));
+        planeOffsets[ch + 1] = planeOffsets[ch] + size;
+    }
+    ParallelFor(channels, m_ThreadCount, [&](int ch, int)
+    {
+        ZfpDecompressFields(ZfpMakeField(data + ch, width, height, channels, false), 1, m_Mode, cmp + planeOffsets[ch], planeOffsets[ch + 1] - planeOffsets[ch]);
+    });
+}
+
+std::vector<int> ZfpCompressor::GetLevels() const
+{
+    switch (m_Mode)
+    {
+    case kZfpAccuracy: return { 0, 1, 2, 3, 4 };
+    case kZfpPrecision: return { 8, 12, 16, 20, 24 };
+    case kZfpRate: return { 2, 4, 8, 12, 16 };
+    default: return { 0 };
+    }
+}
+
+double ZfpCompressor::GetErrorBound(int level) const
+{
+    if (m_Mode == kZfpReversible)
+        return 0.0;
+    if (m_Mode == kZfpAccuracy)
+        return pow(10.0, -level);
+    return -1.0; // precision / rate modes have no absolute error guarantee
+}
+
 void ZfpCompressor::PrintName(size_t bufSize, char* buf) const
 {
-    snprintf(buf, bufSize, "zfp-ls");
+    const char* kModeNames[] = { "ls", "acc", "prec", "rate" };
+    const char* kLayoutNames[] = { "", "-planes", "-chdim" };
+    // strided / channel dim: thread count other than one means OpenMP
+    char threads[40];
+    PrintChunkedSuffix(sizeof(threads), threads, 0, m_ThreadCount);
+    const char* omp = m_Layout != kZfpLayoutPlanes && m_ThreadCount != 1 ? "-omp" : "";
+    snprintf(buf, bufSize, "zfp-%s%s%s%s", kModeNames[m_Mode], kLayoutNames[m_Layout], omp, threads);
 }
 
 void ZfpCompressor::PrintVersion(size_t bufSize, char* buf) const
@@ -357,6 +772,13 @@ uint8_t* SpdpCompressor::Compress(int level, const float* data, int width, int h
     Split<uint32_t>((const uint32_t*)data, split, channels, width * height);
 
     size_t dataSize = width * height * channels * sizeof(float);
+    if (m_ChunkSize != 0)
+    {
+        uint8_t* cmp = new uint8_t[spdp_mt_compress_bound(dataSize, m_ChunkSize)];
+        outSize = spdp_mt_compress(level, (const uint8_t*)split, dataSize, m_ChunkSize, m_ThreadCount, cmp);
+        delete[] split;
+        return cmp;
+    }
     size_t bound = spdp_compress_bound(dataSize);
     uint8_t* cmp = new uint8_t[bound + 1];
     cmp[0] = uint8_t(level);
@@ -369,15 +791,29 @@ uint8_t* SpdpCompressor::Compress(int level, const float* data, int width, int h
 void SpdpCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
 {
     uint32_t* split = new uint32_t[width * height * channels];
-    uint8_t level = cmp[0];
-    spdp_decompress(level, cmpSize - 1, (byte_t*)cmp + 1, (byte_t*)split);
+    if (m_ChunkSize != 0)
+    {
+        spdp_mt_decompress(cmp, cmpSize, (uint8_t*)split, width * height * channels * sizeof(float), m_ThreadCount);
+    }
+    else
+    {
+        uint8_t level = cmp[0];
+        spdp_decompress(level, cmpSize - 1, (byte_t*)cmp + 1, (byte_t*)split);
+    }
     UnSplit<uint32_t>(split, (uint32_t*)data, channels, width * height);
     delete[] split;
 }
 
 void SpdpCompressor::PrintName(size_t bufSize, char* buf) const
 {
-    snprintf(buf, bufSize, "spdp");
+    if (m_ChunkSize == 0)
+    {
+        snprintf(buf, bufSize, "spdp");
+        return;
+    }
+    char suffix[40];
+    PrintChunkedSuffix(sizeof(suffix), suffix, 0, m_ThreadCount);
+    snprintf(buf, bufSize, "spdp-c%ik%s", m_ChunkSize / 1024, suffix);
 }
 
 void SpdpCompressor::PrintVersion(size_t bufSize, char* buf) const
@@ -387,13 +823,14 @@ void SpdpCompressor::PrintVersion(size_t bufSize, char* buf) const
 
 
 #if BUILD_WITH_NDZIP
-uint8_t* NdzipCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+// threadCount: ndzip's own (OpenMP) threads, only with NDZIP_WITH_MT build
+static uint8_t* NdzipCompressImage(const float* data, int width, int height, int channels, int threadCount, size_t& outSize)
 {
     // without s32 split, only achieves 1.2x ratio; with split 2.5x
     uint32_t* split = new uint32_t[width * height * channels];
     Split<uint32_t>((const uint32_t*)data, split, channels, width * height);
 
-    auto compressor = ndzip::make_compressor<float>(2, 1);
+    auto compressor = ndzip::make_compressor<float>(2, threadCount > 0 ? threadCount : GetHardwareThreadCount());
 
     ndzip::extent ext(2);
     ext[0] = width;
@@ -412,9 +849,9 @@ uint8_t* NdzipCompressor::Compress(int level, const float* data, int width, int
     return cmp;
 }
 
-void NdzipCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+static void NdzipDecompressImage(const uint8_t* cmp, float* data, int width, int height, int channels, int threadCount)
 {
-    auto decompressor = ndzip::make_decompressor<float>(2, 1);
+    auto decompressor = ndzip::make_decompressor<float>(2, threadCount > 0 ? threadCount : GetHardwareThreadCount());
     ndzip::extent ext(2);
     ext[0] = width;
     ext[1] = height;
@@ -430,9 +867,34 @@ void NdzipCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data
     delete[] split;
 }
 
+uint8_t* NdzipCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    if (m_ChunkRows == 0)
+        return NdzipCompressImage(data, width, height, channels, m_ThreadCount, outSize);
+    return CompressChunked(data, width, height, channels, m_ChunkRows, m_ThreadCount, outSize, [](const float* chunkData, int chunkWidth, int chunkHeight, int chunkChannels, size_t& chunkSize)
+    {
+        return NdzipCompressImage(chunkData, chunkWidth, chunkHeight, chunkChannels, 1, chunkSize);
+    });
+}
+
+void NdzipCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    if (m_ChunkRows == 0)
+    {
+        NdzipDecompressImage(cmp, data, width, height, channels, m_ThreadCount);
+        return;
+    }
+    DecompressChunked(cmp, cmpSize, data, width, height, channels, m_ThreadCount, [](const uint8_t* chunkCmp, size_t chunkCmpSize, float* chunkData, int chunkWidth, int chunkHeight, int chunkChannels)
+    {
+        NdzipDecompressImage(chunkCmp, chunkData, chunkWidth, chunkHeight, chunkChannels, 1);
+    });
+}
+
 void NdzipCompressor::PrintName(size_t bufSize, char* buf) const
 {
-    snprintf(buf, bufSize, "ndzip");
+    char suffix[40];
+    PrintChunkedSuffix(sizeof(suffix), suffix, m_ChunkRows, m_ThreadCount);
+    snprintf(buf, bufSize, "ndzip%s", suffix);
 }
 void NdzipCompressor::PrintVersion(size_t bufSize, char* buf) const
 {
@@ -508,3 +970,744 @@ void StreamVByteCompressor::PrintVersion(size_t bufSize, char* buf) const
 {
     snprintf(buf, bufSize, "svbyte-2023.02");
 }
+
+
+uint8_t* PForCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    size_t dataElems = size_t(width) * height;
+    uint8_t* cmp = new uint8_t[pfor_compress_bound(dataElems, channels)];
+    size_t cmpSize = pfor_compress(data, dataElems, channels, cmp);
+    return CompressGeneric(m_Format, level, cmp, cmpSize, 4, outSize);
+}
+
+void PForCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    size_t decompSize;
+    uint8_t* decomp = DecompressGeneric(m_Format, cmp, cmpSize, decompSize);
+    pfor_decompress(decomp, decompSize, data, size_t(width) * height, channels);
+    if (decomp != cmp) delete[] decomp;
+}
+
+std::vector<int> PForCompressor::GetLevels() const
+{
+    return GetGenericLevelRange(m_Format);
+}
+
+void PForCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    if (m_Format == kCompressionCount)
+        snprintf(buf, bufSize, "pfor");
+    else
+        snprintf(buf, bufSize, "pfor-%s", kCompressionFormatNames[m_Format]);
+}
+
+void PForCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    if (m_Format == kCompressionCount)
+        snprintf(buf, bufSize, "pfor");
+    else
+        compressor_get_version(m_Format, bufSize, buf);
+}
+
+
+uint8_t* LZ4StreamCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    size_t dataSize = width * height * channels * sizeof(float);
+    size_t blockCount = (dataSize + m_BlockSize - 1) / m_BlockSize;
+    size_t bound = blockCount * (4 + LZ4_compressBound(m_BlockSize));
+    uint8_t* cmp = new uint8_t[bound];
+
+    LZ4_stream_t* stream = nullptr;
+    LZ4_streamHC_t* streamHC = nullptr;
+    if (level > 0)
+        streamHC = LZ4_createStreamHC();
+    else
+        stream = LZ4_createStream();
+
+    const char* src = (const char*)data;
+    size_t srcOffset = 0;
+    size_t cmpOffset = 0;
+    for (size_t ib = 0; ib < blockCount; ++ib)
+    {
+        int blockSize = int(std::min<size_t>(m_BlockSize, dataSize - srcOffset));
+        // reset history every N blocks; previous input data stays in place in memory
+        // and is used as the dictionary otherwise
+        bool reset = ib == 0 || (m_ResetInterval > 0 && (ib % m_ResetInterval) == 0);
+        char* dst = (char*)cmp + cmpOffset + 4;
+        int dstCap = int(bound - cmpOffset - 4);
+        int blockCmpSize;
+        if (level > 0)
+        {
+            if (reset)
+                LZ4_resetStreamHC_fast(streamHC, level);
+            blockCmpSize = LZ4_compress_HC_continue(streamHC, src + srcOffset, dst, blockSize, dstCap);
+        }
+        else
+        {
+            if (reset)
+                LZ4_resetStream_fast(stream);
+            blockCmpSize = LZ4_compress_fast_continue(stream, src + srcOffset, dst, blockSize, dstCap, -level * 10);
+        }
+        *(uint32_t*)(cmp + cmpOffset) = uint32_t(blockCmpSize);
+        srcOffset += blockSize;
+        cmpOffset += 4 + blockCmpSize;
+    }
+
+    LZ4_freeStream(stream);
+    LZ4_freeStreamHC(streamHC);
+    outSize = cmpOffset;
+    return cmp;
+}
+
+void LZ4StreamCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    size_t dataSize = width * height * channels * sizeof(float);
+    LZ4_streamDecode_t* stream = LZ4_createStreamDecode();
+
+    char* dst = (char*)data;
+    size_t dstOffset = 0;
+    size_t cmpOffset = 0;
+    size_t ib = 0;
+    while (dstOffset < dataSize)
+    {
+        int blockSize = int(std::min<size_t>(m_BlockSize, dataSize - dstOffset));
+        uint32_t blockCmpSize = *(const uint32_t*)(cmp + cmpOffset);
+        // decompressing into one contiguous output buffer, so previous blocks are
+        // directly usable as history
+        if (ib == 0 || (m_ResetInterval > 0 && (ib % m_ResetInterval) == 0))
+            LZ4_setStreamDecode(stream, nullptr, 0);
+        LZ4_decompress_safe_continue(stream, (const char*)cmp + cmpOffset + 4, dst + dstOffset, int(blockCmpSize), blockSize);
+        dstOffset += blockSize;
+        cmpOffset += 4 + blockCmpSize;
+        ++ib;
+    }
+    LZ4_freeStreamDecode(stream);
+}
+
+std::vector<int> LZ4StreamCompressor::GetLevels() const
+{
+    return GetGenericLevelRange(kCompressionLZ4);
+}
+
+void LZ4StreamCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    if (m_ResetInterval > 0)
+        snprintf(buf, bufSize, "lz4s-%ik-r%i", m_BlockSize / 1024, m_ResetInterval);
+    else
+        snprintf(buf, bufSize, "lz4s-%ik", m_BlockSize / 1024);
+}
+
+void LZ4StreamCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    snprintf(buf, bufSize, "lz4-%s", LZ4_versionString());
+}
+
+uint8_t* LZSSE8SegmentedCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    size_t dataSize = width * height * channels * sizeof(float);
+    int segCount = int((dataSize + m_SegmentSize - 1) / m_SegmentSize);
+    size_t headerSize = 4 + segCount * 4;
+    // LZSSE8 output is never larger than input (stores raw if it would be),
+    // so each segment can be compressed in place at its source offset
+    uint8_t* cmp = new uint8_t[headerSize + dataSize];
+    uint32_t* segSizes = (uint32_t*)(cmp + 4);
+    *(uint32_t*)cmp = uint32_t(segCount);
+
+    int threadCount = std::min(m_ThreadCount > 0 ? m_ThreadCount : GetHardwareThreadCount(), segCount);
+    std::vector<LZSSE8_OptimalParseState*> optStates(threadCount, nullptr);
+    std::vector<LZSSE8_FastParseState*> fastStates(threadCount, nullptr);
+    ParallelFor(segCount, threadCount, [&](int is, int it)
+    {
+        size_t offset = size_t(is) * m_SegmentSize;
+        size_t size = std::min<size_t>(m_SegmentSize, dataSize - offset);
+        const uint8_t* src = (const uint8_t*)data + offset;
+        uint8_t* dst = cmp + headerSize + offset;
+        if (level > 0)
+        {
+            if (!optStates[it])
+                optStates[it] = LZSSE8_MakeOptimalParseState(m_SegmentSize);
+            segSizes[is] = uint32_t(LZSSE8_CompressOptimalParse(optStates[it], src, size, dst, size, level));
+        }
+        else
+        {
+            if (!fastStates[it])
+                fastStates[it] = LZSSE8_MakeFastParseState();
+            segSizes[is] = uint32_t(LZSSE8_CompressFast(fastStates[it], src, size, dst, size));
+        }
+    });
+    for (auto* st : optStates)
+        if (st) LZSSE8_FreeOptimalParseState(st);
+    for (auto* st : fastStates)
+        if (st) LZSSE8_FreeFastParseState(st);
+
+    // pack compressed segments together; they only move towards the start
+    size_t cmpOffset = headerSize;
+    for (int is = 0; is < segCount; ++is)
+    {
+        memmove(cmp + cmpOffset, cmp + headerSize + size_t(is) * m_SegmentSize, segSizes[is]);
+        cmpOffset += segSizes[is];
+    }
+    outSize = cmpOffset;
+    return cmp;
+}
+
+void LZSSE8SegmentedCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    size_t dataSize = width * height * channels * sizeof(float);
+    int segCount = *(const uint32_t*)cmp;
+    const uint32_t* segSizes = (const uint32_t*)(cmp + 4);
+    std::vector<size_t> segOffsets(segCount);
+    size_t cmpOffset = 4 + segCount * 4;
+    for (int is = 0; is < segCount; ++is)
+    {
+        segOffsets[is] = cmpOffset;
+        cmpOffset += segSizes[is];
+    }
+
+    ParallelFor(segCount, m_ThreadCount, [&](int is, int)
+    {
+        size_t offset = size_t(is) * m_SegmentSize;
+        size_t size = std::min<size_t>(m_SegmentSize, dataSize - offset);
+        LZSSE8_Decompress(cmp + segOffsets[is], segSizes[is], (uint8_t*)data + offset, size);
+    });
+}
+
+std::vector<int> LZSSE8SegmentedCompressor::GetLevels() const
+{
+    return { 0, 1, 2, 4, 8 }; // higher levels give same results on our data
+}
+
+void LZSSE8SegmentedCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    char threads[40];
+    PrintChunkedSuffix(sizeof(threads), threads, 0, m_ThreadCount);
+    snprintf(buf, bufSize, "lzsse8-seg%ik%s", m_SegmentSize / 1024, threads);
+}
+
+void LZSSE8SegmentedCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    compressor_get_version(kCompressionLZSSE8, bufSize, buf);
+}
+
+uint8_t* ChimpCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    size_t dataElems = size_t(width) * height;
+    uint8_t* cmp = new uint8_t[chimp_compress_bound(dataElems, channels)];
+    outSize = chimp_compress(m_Chimp128 ? kChimpChimp128 : kChimpGorilla, data, dataElems, channels, cmp);
+    return cmp;
+}
+
+void ChimpCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    size_t dataElems = size_t(width) * height;
+    chimp_decompress(m_Chimp128 ? kChimpChimp128 : kChimpGorilla, cmp, cmpSize, data, dataElems, channels);
+}
+
+void ChimpCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    snprintf(buf, bufSize, "%s", m_Chimp128 ? "chimp128" : "gorilla");
+}
+
+void ChimpCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    snprintf(buf, bufSize, "%s", m_Chimp128 ? "chimp128-2022" : "gorilla-2015");
+}
+
+uint8_t* AlpCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    size_t dataElems = size_t(width) * height;
+    uint8_t* cmp = new uint8_t[alp_compress_bound(dataElems, channels)];
+    outSize = alp_compress(data, dataElems, channels, cmp);
+    return cmp;
+}
+
+void AlpCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    size_t dataElems = size_t(width) * height;
+    alp_decompress(cmp, cmpSize, data, dataElems, channels);
+}
+
+void AlpCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    snprintf(buf, bufSize, "alp");
+}
+
+void AlpCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    snprintf(buf, bufSize, "alp-2023");
+}
+
+uint8_t* FpcCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    size_t dataElems = size_t(width) * height;
+    uint8_t* cmp = new uint8_t[fpc_compress_bound(dataElems, channels)];
+    outSize = fpc_compress(data, dataElems, channels, level, m_ThreadCount, cmp);
+    return cmp;
+}
+
+void FpcCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    size_t dataElems = size_t(width) * height;
+    fpc_decompress(cmp, cmpSize, data, dataElems, channels, m_ThreadCount);
+}
+
+std::vector<int> FpcCompressor::GetLevels() const
+{
+    return { 8, 10, 12, 14, 16 };
+}
+
+void FpcCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    char threads[40];
+    PrintChunkedSuffix(sizeof(threads), threads, 0, m_ThreadCount);
+    snprintf(buf, bufSize, "fpc%s", threads);
+}
+
+void FpcCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    snprintf(buf, bufSize, "fpc-2009");
+}
+
+uint8_t* SzCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    uint8_t* cmp = new uint8_t[sz_compress_bound(width, height, channels, m_Format)];
+    outSize = sz_compress(data, width, height, channels, GetErrorBound(level), m_Format, m_ThreadCount, cmp);
+    return cmp;
+}
+
+void SzCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    sz_decompress(cmp, cmpSize, data, width, height, channels, m_ThreadCount);
+}
+
+std::vector<int> SzCompressor::GetLevels() const
+{
+    return { 0, 1, 2, 3, 4 };
+}
+
+double SzCompressor::GetErrorBound(int level) const
+{
+    return pow(10.0, -level);
+}
+
+void SzCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    char threads[40];
+    PrintChunkedSuffix(sizeof(threads), threads, 0, m_ThreadCount);
+    snprintf(buf, bufSize, "sz-%s%s", kCompressionFormatNames[m_Format], threads);
+}
+
+void SzCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    snprintf(buf, bufSize, "sz-2018");
+}
+
+uint8_t* CmCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    uint8_t* cmp = new uint8_t[cm_compress_bound(width, height, channels)];
+    outSize = cm_compress(data, width, height, channels, level, m_ThreadCount, cmp);
+    return cmp;
+}
+
+void CmCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    cm_decompress(cmp, cmpSize, data, width, height, channels, m_ThreadCount);
+}
+
+std::vector<int> CmCompressor::GetLevels() const
+{
+    return { 0, 1, 2 };
+}
+
+void CmCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    char threads[40];
+    PrintChunkedSuffix(sizeof(threads), threads, 0, m_ThreadCount);
+    snprintf(buf, bufSize, "cm%s", threads);
+}
+
+void CmCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    snprintf(buf, bufSize, "cm-2024");
+}
+
+// packed data: each channel as its own block of split + delta filtered byte planes,
+// 2 (converted channels) or 4 bytes per value
+uint8_t* HalfCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    size_t dataElems = size_t(width) * height;
+    size_t packedSize = 0;
+    for (int ch = 0; ch < channels; ++ch)
+        packedSize += dataElems * ((m_ChannelMask & (1u << ch)) ? 2 : 4);
+    uint8_t* packed = new uint8_t[packedSize];
+    uint8_t* tmp = new uint8_t[dataElems * 4];
+    uint8_t* dst = packed;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        int valueSize = 4;
+        if (m_ChannelMask & (1u << ch))
+        {
+            half_pack_channel(data + ch, channels, dataElems, m_Half, (uint16_t*)tmp);
+            valueSize = 2;
+        }
+        else
+        {
+            for (size_t i = 0; i < dataElems; ++i)
+                ((float*)tmp)[i] = data[i * channels + ch];
+        }
+        Filter_H(tmp, dst, valueSize, dataElems);
+        dst += dataElems * valueSize;
+    }
+    delete[] tmp;
+
+    size_t bound = compress_calc_bound(packedSize, m_Format);
+    uint8_t* cmp = new uint8_t[bound];
+    outSize = compress_data(packed, packedSize, cmp, bound, m_Format, level, int(packedSize / std::max<size_t>(dataElems, 1)));
+    delete[] packed;
+    return cmp;
+}
+
+void HalfCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    size_t dataElems = size_t(width) * height;
+    size_t packedSize = 0;
+    for (int ch = 0; ch < channels; ++ch)
+        packedSize += dataElems * ((m_ChannelMask & (1u << ch)) ? 2 : 4);
+    uint8_t* packed = new uint8_t[packedSize];
+    decompress_data(cmp, cmpSize, packed, packedSize, m_Format);
+    uint8_t* tmp = new uint8_t[dataElems * 4];
+    const uint8_t* src = packed;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        if (m_ChannelMask & (1u << ch))
+        {
+            UnFilter_H(src, tmp, 2, dataElems);
+            half_unpack_channel((const uint16_t*)tmp, dataElems, m_Half, data + ch, channels);
+            src += dataElems * 2;
+        }
+        else
+        {
+            UnFilter_K(src, tmp, 4, dataElems);
+            for (size_t i = 0; i < dataElems; ++i)
+                data[i * channels + ch] = ((const float*)tmp)[i];
+            src += dataElems * 4;
+        }
+    }
+    delete[] tmp;
+    delete[] packed;
+}
+
+std::vector<int> HalfCompressor::GetLevels() const
+{
+    return GetGenericLevelRange(m_Format);
+}
+
+void HalfCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    // converted channel list, unless it is all channels
+    char chlist[40] = "";
+    if (m_ChannelMask != ~0u)
+    {
+        char* p = chlist + snprintf(chlist, sizeof(chlist), "-ch");
+        for (int ch = 0; ch < 32 && p < chlist + sizeof(chlist) - 2; ++ch)
+            if (m_ChannelMask & (1u << ch))
+                *p++ = ch < 10 ? char('0' + ch) : char('a' + ch - 10);
+        *p = 0;
+    }
+    snprintf(buf, bufSize, "%s%s-%s", m_Half == kHalfBf16 ? "bf16" : "f16", chlist, kCompressionFormatNames[m_Format]);
+}
+
+void HalfCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    compressor_get_version(m_Format, bufSize, buf);
+}
+
+
+static bool MeshOptFilterApplies(MeshOptFilter filter, const float* data, int channels, size_t dataElems)
+{
+    if (filter == kMeshOptFilterExp)
+        return true;
+    if (filter == kMeshOptFilterQuat && channels != 4)
+        return false;
+    if (filter == kMeshOptFilterOct && channels != 3 && channels != 4)
+        return false;
+    const int lenChannels = filter == kMeshOptFilterQuat ? 4 : 3;
+    for (size_t i = 0; i < dataElems; ++i)
+    {
+        const float* v = data + i * channels;
+        float len2 = 0;
+        for (int ch = 0; ch < lenChannels; ++ch)
+            len2 += v[ch] * v[ch];
+        if (!(fabsf(len2 - 1.0f) < 1.0e-3f)) // also catches NaNs
+            return false;
+        if (filter == kMeshOptFilterOct && channels == 4 && !(fabsf(v[3]) <= 1.0f))
+            return false;
+    }
+    return true;
+}
+
+uint8_t* MeshOptFilterCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    size_t dataElems = size_t(width) * height;
+    MeshOptFilter filter = MeshOptFilterApplies(m_Filter, data, channels, dataElems) ? m_Filter : kMeshOptFilterExp;
+
+    // Exp filter keeps the float layout; quat / oct produce 4x int16 per vector
+    uint8_t* filtered;
+    int stride;
+    if (filter == kMeshOptFilterExp)
+    {
+        stride = channels * sizeof(float);
+        filtered = new uint8_t[dataElems * stride];
+        meshopt_filter_encode(filter, filtered, dataElems, stride, m_Bits, data);
+    }
+    else
+    {
+        stride = 4 * sizeof(int16_t);
+        filtered = new uint8_t[dataElems * stride];
+        const float* src = data;
+        float* padded = nullptr;
+        if (channels == 3)
+        {
+            padded = new float[dataElems * 4];
+            for (size_t i = 0; i < dataElems; ++i)
+            {
+                padded[i * 4 + 0] = data[i * 3 + 0];
+                padded[i * 4 + 1] = data[i * 3 + 1];
+                padded[i * 4 + 2] = data[i * 3 + 2];
+                padded[i * 4 + 3] = 0.0f;
+            }
+            src = padded;
+        }
+        meshopt_filter_encode(filter, filtered, dataElems, stride, m_Bits, src);
+        delete[] padded;
+    }
+
+    // quat filter flips q to -q so that the largest component is positive; remember which
+    // ones were flipped (one bit per vector, after vertex codec data) to restore the sign
+    const size_t flagBytes = filter == kMeshOptFilterQuat ? (dataElems + 7) / 8 : 0;
+    size_t moBound = compress_meshopt_vertex_attribute_bound(int(dataElems), stride);
+    uint8_t* moCmp = new uint8_t[moBound + flagBytes];
+    size_t moSize = compress_meshopt_vertex_attribute(filtered, int(dataElems), stride, moCmp, moBound);
+    delete[] filtered;
+    if (flagBytes != 0)
+    {
+        uint8_t* flags = moCmp + moSize;
+        memset(flags, 0, flagBytes);
+        for (size_t i = 0; i < dataElems; ++i)
+        {
+            // same largest component pick as meshopt_encodeFilterQuat
+            const float* q = data + i * 4;
+            int qc = 0;
+            for (int ch = 1; ch < 4; ++ch)
+                qc = fabsf(q[ch]) > fabsf(q[qc]) ? ch : qc;
+            if (q[qc] < 0.0f)
+                flags[i / 8] |= uint8_t(1 << (i % 8));
+        }
+    }
+
+    size_t genSize;
+    uint8_t* genCmp = CompressGeneric(m_Format, level, moCmp, moSize + flagBytes, stride, genSize);
+
+    // header: filter that was actually used, vertex codec data size
+    outSize = 8 + genSize;
+    uint8_t* cmp = new uint8_t[outSize];
+    uint32_t header[2] = { uint32_t(filter), uint32_t(moSize) };
+    memcpy(cmp, header, 8);
+    memcpy(cmp + 8, genCmp, genSize);
+    delete[] genCmp;
+    return cmp;
+}
+
+void MeshOptFilterCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    size_t dataElems = size_t(width) * height;
+    uint32_t header[2];
+    memcpy(header, cmp, 8);
+    MeshOptFilter filter = MeshOptFilter(header[0]);
+    const size_t moSize = header[1];
+    cmp += 8;
+    cmpSize -= 8;
+
+    size_t decompSize;
+    uint8_t* decomp = DecompressGeneric(m_Format, cmp, cmpSize, decompSize);
+    if (filter == kMeshOptFilterExp)
+    {
+        // decodes straight into float data
+        int stride = channels * sizeof(float);
+        decompress_meshopt_vertex_attribute(decomp, moSize, int(dataElems), stride, data);
+        meshopt_filter_decode(filter, data, dataElems, stride);
+    }
+    else
+    {
+        int stride = 4 * sizeof(int16_t);
+        int16_t* filtered = new int16_t[dataElems * 4];
+        decompress_meshopt_vertex_attribute(decomp, moSize, int(dataElems), stride, filtered);
+        meshopt_filter_decode(filter, filtered, dataElems, stride);
+        const uint8_t* flags = decomp + moSize;
+        const float scale = 1.0f / 32767.0f;
+        for (size_t i = 0; i < dataElems; ++i)
+        {
+            const float s = filter == kMeshOptFilterQuat && (flags[i / 8] & (1 << (i % 8))) ? -scale : scale;
+            for (int ch = 0; ch < channels; ++ch)
+                data[i * channels + ch] = filtered[i * 4 + ch] * s;
+        }
+        delete[] filtered;
+    }
+    if (decomp != cmp) delete[] decomp;
+}
+
+std::vector<int> MeshOptFilterCompressor::GetLevels() const
+{
+    return GetGenericLevelRange(m_Format);
+}
+
+void MeshOptFilterCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    static const char* kFilterNames[] = { "exp", "quat", "oct" };
+    if (m_Format == kCompressionCount)
+        snprintf(buf, bufSize, "meshopt-%s%i", kFilterNames[m_Filter], m_Bits);
+    else
+        snprintf(buf, bufSize, "meshopt-%s%i-%s", kFilterNames[m_Filter], m_Bits, kCompressionFormatNames[m_Format]);
+}
+
+void MeshOptFilterCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    meshopt_get_version(bufSize, buf);
+}
+
+
+// storage bandwidth (MB/s) for each level of adaptive compressor
+static const double kAdaptiveBandwidths[] = { 10, 25, 50, 100, 250 };
+const size_t kAdaptiveSamplePiece = 4 * 1024;
+const size_t kAdaptiveSamplePieces = 16;
+
+uint8_t* AdaptiveCompressor::Compress(int level, const float* data, int width, int height, int channels, size_t& outSize)
+{
+    const size_t dataSize = size_t(width) * height * channels * sizeof(float);
+    const uint8_t* src = (const uint8_t*)data;
+    const double bandwidth = kAdaptiveBandwidths[level] * 1024 * 1024;
+    const int candCount = int(m_Candidates.size());
+
+    // sample: evenly spaced pieces of the input, or all of it when small
+    std::vector<uint8_t> sample;
+    if (dataSize <= kAdaptiveSamplePiece * kAdaptiveSamplePieces)
+        sample.assign(src, src + dataSize);
+    else
+    {
+        const size_t step = (dataSize - kAdaptiveSamplePiece) / (kAdaptiveSamplePieces - 1);
+        for (size_t p = 0; p < kAdaptiveSamplePieces; ++p)
+            sample.insert(sample.end(), src + p * step, src + p * step + kAdaptiveSamplePiece);
+    }
+
+    // probe each candidate on the sample; decompression time from fixed speed, not measured,
+    // so that the same input always picks the same candidate
+    int best = 0;
+    if (candCount > 1 && !sample.empty())
+    {
+        double bestCost = 0;
+        for (int ic = 0; ic < candCount; ++ic)
+        {
+            const Candidate& cand = m_Candidates[ic];
+            std::vector<uint8_t> cmp(compress_calc_bound(sample.size(), cand.format));
+            size_t cmpSize = compress_data(sample.data(), sample.size(), cmp.data(), cmp.size(), cand.format, cand.level, channels * sizeof(float));
+            double decTime = sample.size() / (cand.decodeSpeed * 1024 * 1024);
+            double cost = cmpSize / bandwidth + decTime;
+            if (ic == 0 || cost < bestCost)
+            {
+                best = ic;
+                bestCost = cost;
+            }
+        }
+    }
+
+    if (m_PickedBlocks.size() <= size_t(level))
+    {
+        m_PickedBlocks.resize(level + 1);
+        m_PickedBytes.resize(level + 1);
+    }
+    m_PickedBlocks[level].resize(candCount);
+    m_PickedBytes[level].resize(candCount);
+    m_PickedBlocks[level][best]++;
+    m_PickedBytes[level][best] += dataSize;
+
+    // format tag, then the data compressed with picked candidate
+    const Candidate& cand = m_Candidates[best];
+    size_t bound = 1 + compress_calc_bound(dataSize, cand.format);
+    uint8_t* cmp = new uint8_t[bound];
+    cmp[0] = uint8_t(cand.format);
+    outSize = 1 + compress_data(data, dataSize, cmp + 1, bound - 1, cand.format, cand.level, channels * sizeof(float));
+    return cmp;
+}
+
+void AdaptiveCompressor::Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels)
+{
+    size_t dataSize = size_t(width) * height * channels * sizeof(float);
+    decompress_data(cmp + 1, cmpSize - 1, data, dataSize, CompressionFormat(cmp[0]));
+}
+
+std::vector<int> AdaptiveCompressor::GetLevels() const
+{
+    std::vector<int> levels;
+    for (int i = 0; i < int(std::size(kAdaptiveBandwidths)); ++i)
+        levels.push_back(i);
+    return levels;
+}
+
+static void PrintCandidateName(size_t bufSize, char* buf, const AdaptiveCompressor::Candidate& cand)
+{
+    if (cand.level != 0)
+        snprintf(buf, bufSize, "%s%i", kCompressionFormatNames[cand.format], cand.level);
+    else
+        snprintf(buf, bufSize, "%s", kCompressionFormatNames[cand.format]);
+}
+
+void AdaptiveCompressor::PrintName(size_t bufSize, char* buf) const
+{
+    std::string name = "adapt";
+    for (const Candidate& cand : m_Candidates)
+    {
+        char candName[64];
+        PrintCandidateName(sizeof(candName), candName, cand);
+        name += "-";
+        name += candName;
+    }
+    snprintf(buf, bufSize, "%s", name.c_str());
+}
+
+void AdaptiveCompressor::PrintVersion(size_t bufSize, char* buf) const
+{
+    std::string version;
+    std::set<CompressionFormat> formats;
+    for (const Candidate& cand : m_Candidates)
+    {
+        if (!formats.insert(cand.format).second)
+            continue;
+        char candVersion[64];
+        compressor_get_version(cand.format, sizeof(candVersion), candVersion);
+        if (!version.empty())
+            version += " ";
+        version += candVersion;
+    }
+    snprintf(buf, bufSize, "%s", version.c_str());
+}
+
+void AdaptiveCompressor::PrintStats(const char* name, int runs) const
+{
+    printf("%s picked codecs (blocks per run, share of data):\n", name);
+    for (size_t level = 0; level < m_PickedBlocks.size(); ++level)
+    {
+        size_t totalBytes = 0;
+        for (size_t bytes : m_PickedBytes[level])
+            totalBytes += bytes;
+        if (totalBytes == 0)
+            continue;
+        printf("  level %zi (%.0f MB/s):", level, kAdaptiveBandwidths[level]);
+        for (size_t ic = 0; ic < m_PickedBlocks[level].size(); ++ic)
+        {
+            char candName[64];
+            PrintCandidateName(sizeof(candName), candName, m_Candidates[ic]);
+            printf(" %s %zi %.1f%%", candName, m_PickedBlocks[level][ic] / runs, m_PickedBytes[level][ic] * 100.0 / totalBytes);
+        }
+        printf("\n");
+    }
+}
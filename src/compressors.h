@@ -1,5 +1,6 @@
 #pragma once
 #include "compression_helpers.h"
+#include "halffloat.h"
 #include <stddef.h>
 #include <vector>
 
@@ -11,17 +12,25 @@ struct Compressor
 	virtual std::vector<int> GetLevels() const { return {0}; }
 	virtual void PrintName(size_t bufSize, char* buf) const = 0;
 	virtual void PrintVersion(size_t bufSize, char* buf) const = 0;
+	// lossy compressors: max. absolute error allowed at a level; negative if there is no absolute bound
+	virtual bool IsLossless() const { return true; }
+	virtual double GetErrorBound(int level) const { return 0.0; }
 };
 
+// planeBypass: input is treated as channels*4 byte planes (output of the split filters);
+// planes that look incompressible are stored raw, and only runs of the remaining planes go
+// through the codec. A sample of each plane is checked: close to 8 bits order-0 entropy
+// (only for codecs that have entropy coding), and a fast LZ4 probe gains under 3%.
 struct GenericCompressor : public Compressor
 {
-	GenericCompressor(CompressionFormat format) : m_Format(format) {}
+	GenericCompressor(CompressionFormat format, bool planeBypass = false) : m_Format(format), m_PlaneBypass(planeBypass) {}
 	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
 	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
 	virtual std::vector<int> GetLevels() const;
 	virtual void PrintName(size_t bufSize, char* buf) const;
 	virtual void PrintVersion(size_t bufSize, char* buf) const;
 	CompressionFormat m_Format;
+	bool m_PlaneBypass;
 };
 
 struct MeshOptCompressor : public Compressor
@@ -35,38 +44,77 @@ struct MeshOptCompressor : public Compressor
 	CompressionFormat m_Format;
 };
 
+// chunkRows: 0 compresses whole image at once; otherwise bands of that many rows are
+// compressed independently, threadCount of them in parallel (0: all hardware threads).
+// ndzip without chunks uses threadCount for its own multithreading.
 struct FpzipCompressor : public Compressor
 {
+	FpzipCompressor(int chunkRows = 0, int threadCount = 1) : m_ChunkRows(chunkRows), m_ThreadCount(threadCount) {}
 	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
 	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
 	virtual void PrintName(size_t bufSize, char* buf) const;
     virtual void PrintVersion(size_t bufSize, char* buf) const;
+	int m_ChunkRows;
+	int m_ThreadCount;
 };
 
+enum ZfpMode
+{
+	kZfpReversible,
+	kZfpAccuracy,	// level N: absolute error tolerance 10^-N
+	kZfpPrecision,	// level N: N bit planes
+	kZfpRate,		// level N: N bits per value
+};
+
+enum ZfpLayout
+{
+	kZfpLayoutStrided,		// each channel as a strided field, one after another in one stream
+	kZfpLayoutPlanes,		// each channel into a separate stream; compressed & decompressed in parallel
+	kZfpLayoutChannelDim,	// channels as an extra (last) dimension of one field
+};
+
+// Thread count: for strided / channel dim layouts anything other than 1 uses zfp OpenMP
+// execution (compression only); for planes layout it is the number of channel streams
+// processed in parallel. 0 means all hardware threads.
 struct ZfpCompressor : public Compressor
 {
+	ZfpCompressor(ZfpMode mode = kZfpReversible, ZfpLayout layout = kZfpLayoutStrided, int threadCount = 1) : m_Mode(mode), m_Layout(layout), m_ThreadCount(threadCount) {}
 	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
 	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
 	virtual void PrintName(size_t bufSize, char* buf) const;
     virtual void PrintVersion(size_t bufSize, char* buf) const;
+	virtual bool IsLossless() const { return m_Mode == kZfpReversible; }
+	virtual double GetErrorBound(int level) const;
+	ZfpMode m_Mode;
+	ZfpLayout m_Layout;
+	int m_ThreadCount;
 };
 
+// chunkSize: 0 compresses whole data with original SPDP code; otherwise independent chunks
+// of that many bytes with SIMD delta stages, threadCount of them in parallel (0: all threads).
 struct SpdpCompressor : public Compressor
 {
+    SpdpCompressor(int chunkSize = 0, int threadCount = 1) : m_ChunkSize(chunkSize), m_ThreadCount(threadCount) {}
     virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
     virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
     virtual void PrintName(size_t bufSize, char* buf) const;
     virtual void PrintVersion(size_t bufSize, char* buf) const;
     virtual std::vector<int> GetLevels() const;
+    int m_ChunkSize;
+    int m_ThreadCount;
 };
 
 #if BUILD_WITH_NDZIP
 struct NdzipCompressor : public Compressor
 {
+	NdzipCompressor(int chunkRows = 0, int threadCount = 1) : m_ChunkRows(chunkRows), m_ThreadCount(threadCount) {}
 	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
 	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
 	virtual void PrintName(size_t bufSize, char* buf) const;
     virtual void PrintVersion(size_t bufSize, char* buf) const;
+	int m_ChunkRows;
+	int m_ThreadCount;
 };
 #endif // #if BUILD_WITH_NDZIP
 
@@ -82,3 +130,180 @@ struct StreamVByteCompressor : public Compressor
 	bool m_Split32;
 	bool m_Delta;
 };
+
+// FastPFor style: split + delta + zigzag, frame of reference SIMD bit packing with patched
+// exceptions; optionally followed by a generic compressor.
+struct PForCompressor : public Compressor
+{
+	PForCompressor(CompressionFormat format) : m_Format(format) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	CompressionFormat m_Format;
+};
+
+// LZ4 on fixed size blocks, using LZ4 streaming API so that each block can reference
+// data of previous blocks (64KB window). History is reset every resetInterval blocks,
+// which gives random access points; resetInterval 1 means fully independent blocks,
+// 0 means never reset.
+struct LZ4StreamCompressor : public Compressor
+{
+	LZ4StreamCompressor(int blockSize, int resetInterval) : m_BlockSize(blockSize), m_ResetInterval(resetInterval) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	int m_BlockSize;
+	int m_ResetInterval;
+};
+
+// LZSSE8 on independent segments, compressed and decompressed in parallel on up to
+// threadCount threads (0: all hardware threads). Each thread keeps one parse state
+// sized to a segment, so memory use is bounded regardless of input size.
+// Output starts with a segment table (count, compressed size of each segment).
+struct LZSSE8SegmentedCompressor : public Compressor
+{
+	LZSSE8SegmentedCompressor(int segmentSize, int threadCount) : m_SegmentSize(segmentSize), m_ThreadCount(threadCount) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	int m_SegmentSize;
+	int m_ThreadCount;
+};
+
+// Gorilla / Chimp128 XOR float codecs, each channel coded as its own stream.
+struct ChimpCompressor : public Compressor
+{
+	ChimpCompressor(bool chimp128) : m_Chimp128(chimp128) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	bool m_Chimp128;
+};
+
+// ALP style decimal float codec: per block exponent/factor, values as integers with
+// frame-of-reference bit packing, exceptions for values that do not round-trip.
+struct AlpCompressor : public Compressor
+{
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+};
+
+// FPC style FCM/DFCM hash predictor codec. Input is split into independent chunks
+// coded on up to threadCount threads (0: all hardware threads). Level is log2 of the
+// predictor table size.
+struct FpcCompressor : public Compressor
+{
+	FpcCompressor(int threadCount) : m_ThreadCount(threadCount) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	int m_ThreadCount;
+};
+
+// SZ style error bounded lossy codec: Lorenzo / regression prediction, quantization,
+// bins entropy coded with the given generic compressor. Level N is absolute error
+// bound of 10^-N. Row bands are coded on up to threadCount threads (0: all).
+struct SzCompressor : public Compressor
+{
+	SzCompressor(CompressionFormat format, int threadCount) : m_Format(format), m_ThreadCount(threadCount) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	virtual bool IsLossless() const { return false; }
+	virtual double GetErrorBound(int level) const;
+	CompressionFormat m_Format;
+	int m_ThreadCount;
+};
+
+// Bitwise context mixing over byte planes: slow, for high ratio archival. Level 0..2
+// picks model size; row bands are coded on up to threadCount threads (0: all), within
+// a fixed memory budget.
+struct CmCompressor : public Compressor
+{
+	CmCompressor(int threadCount) : m_ThreadCount(threadCount) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	int m_ThreadCount;
+};
+
+// Lossy: channels in channelMask are converted to fp16 / bf16 (others stay float32),
+// each channel is split + delta filtered on its own, and the result is compressed with
+// the given generic compressor.
+struct HalfCompressor : public Compressor
+{
+	HalfCompressor(CompressionFormat format, HalfFormat half, uint32_t channelMask) : m_Format(format), m_Half(half), m_ChannelMask(channelMask) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	virtual bool IsLossless() const { return false; }
+	virtual double GetErrorBound(int level) const { return -1.0; } // relative error only
+	CompressionFormat m_Format;
+	HalfFormat m_Half;
+	uint32_t m_ChannelMask;
+};
+
+// Lossy: mesh optimizer attribute filter, then mesh optimizer vertex codec, then optionally
+// a generic compressor. Exp filter works on any data (shared exponent per vector, "bits" of
+// mantissa); quaternion / octahedral filters are used instead when all the data are unit
+// quaternions / unit vectors (+ w in [-1..1]), and fall back to Exp filter otherwise.
+// Quaternion filter stores q or -q (largest component positive); a sign bit per vector is
+// stored too so that decompression gives back the input sign.
+struct MeshOptFilterCompressor : public Compressor
+{
+	MeshOptFilterCompressor(CompressionFormat format, MeshOptFilter filter, int bits) : m_Format(format), m_Filter(filter), m_Bits(bits) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	virtual bool IsLossless() const { return false; }
+	virtual double GetErrorBound(int level) const { return -1.0; } // relative error only
+	CompressionFormat m_Format;
+	MeshOptFilter m_Filter;
+	int m_Bits;
+};
+
+// Picks one of the candidate codecs for each Compress call, i.e. for each block in block mode.
+// Every candidate compresses a sample of the input (a few pieces spread over it), and the one
+// with the smallest estimated read cost wins: compressed size / bandwidth + decompression time,
+// with time from the candidate's fixed decompression speed so that picks are deterministic.
+// Output is tagged with the picked format. Levels pick the bandwidth, from slow storage (favors
+// ratio) to fast (favors decompression speed). Counts of picked candidates are kept per level,
+// for PrintStats.
+struct AdaptiveCompressor : public Compressor
+{
+	struct Candidate
+	{
+		CompressionFormat format;
+		int level;
+		double decodeSpeed; // MB/s, measured once on split + delta filtered data
+	};
+	AdaptiveCompressor(const std::vector<Candidate>& candidates) : m_Candidates(candidates) {}
+	virtual uint8_t* Compress(int level, const float* data, int width, int height, int channels, size_t& outSize);
+	virtual void Decompress(const uint8_t* cmp, size_t cmpSize, float* data, int width, int height, int channels);
+	virtual std::vector<int> GetLevels() const;
+	virtual void PrintName(size_t bufSize, char* buf) const;
+	virtual void PrintVersion(size_t bufSize, char* buf) const;
+	void PrintStats(const char* name, int runs) const; // counts are divided by runs
+	std::vector<Candidate> m_Candidates;
+	std::vector<std::vector<size_t>> m_PickedBlocks; // [level][candidate]
+	std::vector<std::vector<size_t>> m_PickedBytes; // [level][candidate], uncompressed
+};
@@ -2,6 +2,7 @@
 #include "simd.h"
 #include <assert.h>
 #include <string.h>
+#include <vector>
 
 const size_t kMaxChannels = 64;
 static_assert(kMaxChannels >= 16, "max channels can't be lower than simd width");
@@ -697,6 +698,402 @@ void UnFilter_K(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems
 }
 
 
+// Float field split: byte planes cut the float at byte boundaries, so the exponent ends up
+// spread over two planes. Instead, split each float of the stride into fields:
+// - sign+exponent, 9 bits: exponent byte plane, followed by sign bits packed 8 per byte,
+// - high 7 mantissa bits: groups of 8 values packed into 7 bytes (bits of the 8th value
+//   go into the top bits of the other seven),
+// - low 16 mantissa bits: two byte planes.
+// Each stream gets its own delta choice below. Streams cover multiples of 8 elements, any
+// remaining elements are stored as is at the end. Strides that are not whole floats use H.
+enum FieldDelta { kFieldDeltaNone, kFieldDeltaSub };
+// Picked on the test data: exponent and low mantissa bytes change smoothly, sign bits are
+// mostly runs already (xor with previous byte made them worse), and high mantissa bits after delta lose
+// to the raw ones, since the packing mixes in bits of a different value.
+const FieldDelta kFieldDeltaExp = kFieldDeltaSub;
+const FieldDelta kFieldDeltaSign = kFieldDeltaNone;
+const FieldDelta kFieldDeltaMant7 = kFieldDeltaNone;
+const FieldDelta kFieldDeltaMant16 = kFieldDeltaSub;
+
+static const uint8_t kFieldSplitTable[16] = { 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15 };
+static const uint8_t kFieldBitTable[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+static const uint8_t kFieldBcastMant7Table[16] = { 7, 7, 7, 7, 7, 7, 7, 7, 15, 15, 15, 15, 15, 15, 15, 15 };
+static const uint8_t kFieldBcastSignTable[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1 };
+static const uint8_t kFieldPackMant7Table[16] = { 0, 1, 2, 3, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14, 0x80, 0x80 };
+static const uint8_t kFieldUnpackMant7Table[16] = { 0, 1, 2, 3, 4, 5, 6, 0x80, 7, 8, 9, 10, 11, 12, 13, 0x80 };
+
+// 16 floats (4 vectors) <-> 4 byte planes of 16 bytes (lowest byte first)
+static inline void SplitBytes4x16(Bytes16 v[4], Bytes16 table)
+{
+    for (int k = 0; k < 4; ++k)
+        v[k] = SimdShuffle(v[k], table);
+    Bytes16 a0 = SimdInterleave4L(v[0], v[1]), a1 = SimdInterleave4R(v[0], v[1]);
+    Bytes16 a2 = SimdInterleave4L(v[2], v[3]), a3 = SimdInterleave4R(v[2], v[3]);
+    v[0] = SimdInterleave8L(a0, a2); v[1] = SimdInterleave8R(a0, a2);
+    v[2] = SimdInterleave8L(a1, a3); v[3] = SimdInterleave8R(a1, a3);
+}
+
+static inline void UnSplitBytes4x16(Bytes16 v[4], Bytes16 table)
+{
+    Bytes16 a0 = SimdInterleave4L(v[0], v[1]), a1 = SimdInterleave4R(v[0], v[1]);
+    Bytes16 a2 = SimdInterleave4L(v[2], v[3]), a3 = SimdInterleave4R(v[2], v[3]);
+    v[0] = SimdShuffle(SimdInterleave8L(a0, a2), table); v[1] = SimdShuffle(SimdInterleave8R(a0, a2), table);
+    v[2] = SimdShuffle(SimdInterleave8L(a1, a3), table); v[3] = SimdShuffle(SimdInterleave8R(a1, a3), table);
+}
+
+static inline uint8_t FieldEncode(FieldDelta mode, uint8_t v, uint8_t prev)
+{
+    return mode == kFieldDeltaSub ? uint8_t(v - prev) : v;
+}
+static inline uint8_t FieldDecode(FieldDelta mode, uint8_t v, uint8_t prev)
+{
+    return mode == kFieldDeltaSub ? uint8_t(v + prev) : v;
+}
+static inline Bytes16 FieldEncode(FieldDelta mode, Bytes16 v, Bytes16 prev)
+{
+    return mode == kFieldDeltaSub ? SimdSub(v, SimdConcat<15>(v, prev)) : v;
+}
+// prev: last decoded value broadcast to all lanes
+static inline Bytes16 FieldDecode(FieldDelta mode, Bytes16 v, Bytes16 prev)
+{
+    return mode == kFieldDeltaSub ? SimdAdd(SimdPrefixSum(v), prev) : v;
+}
+
+struct FieldStreams
+{
+    size_t exp, sign, mant7, mant16hi, mant16lo;
+    FieldStreams(size_t n8) : exp(0), sign(n8), mant7(n8 + n8 / 8), mant16hi(n8 * 2), mant16lo(n8 * 3) {}
+};
+
+void Filter_L(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems)
+{
+    if ((channels & 3) != 0)
+    {
+        Filter_H(src, dst, channels, dataElems);
+        return;
+    }
+    const size_t n8 = dataElems & ~size_t(7);
+    const FieldStreams fs(n8);
+    const Bytes16 kSplit = SimdLoad(kFieldSplitTable);
+    const Bytes16 kBits = SimdLoad(kFieldBitTable);
+    const Bytes16 kBcastMant7 = SimdLoad(kFieldBcastMant7Table);
+    const Bytes16 kPackMant7 = SimdLoad(kFieldPackMant7Table);
+    const Bytes16 k7F = SimdSet1(0x7F), k80 = SimdSet1(0x80), kFE = SimdSet1(0xFE), k01 = SimdSet1(0x01);
+    for (int fi = 0; fi < channels / 4; ++fi)
+    {
+        uint8_t* base = dst + fi * n8 * 4;
+        const uint8_t* srcPtr = src + fi * 4;
+        Bytes16 prevExp = SimdZero(), prevMant7 = SimdZero(), prevHi = SimdZero(), prevLo = SimdZero();
+        uint8_t prevSign = 0;
+        size_t i = 0;
+        for (; i + 16 <= n8; i += 16)
+        {
+            uint32_t vals[16];
+            for (int k = 0; k < 16; ++k)
+                memcpy(&vals[k], srcPtr + (i + k) * channels, 4);
+            Bytes16 b[4] = { SimdLoad(vals), SimdLoad(vals + 4), SimdLoad(vals + 8), SimdLoad(vals + 12) };
+            SplitBytes4x16(b, kSplit);
+
+            // sign+exponent
+            Bytes16 exp = SimdOr(SimdAnd(SimdShiftLeftU32(b[3], 1), kFE), SimdAnd(SimdShiftRightU32(b[2], 7), k01));
+            SimdStore(base + fs.exp + i, FieldEncode(kFieldDeltaExp, exp, prevExp));
+            prevExp = exp;
+            uint32_t signs = SimdMoveMask(b[3]);
+            base[fs.sign + i / 8] = FieldEncode(kFieldDeltaSign, uint8_t(signs), prevSign);
+            base[fs.sign + i / 8 + 1] = FieldEncode(kFieldDeltaSign, uint8_t(signs >> 8), uint8_t(signs));
+            prevSign = uint8_t(signs >> 8);
+
+            // high 7 mantissa bits: spread bits of lanes 7 and 15 into top bits of the others
+            Bytes16 mant7 = SimdAnd(b[2], k7F);
+            Bytes16 m = SimdAnd(FieldEncode(kFieldDeltaMant7, mant7, prevMant7), k7F);
+            prevMant7 = mant7;
+            Bytes16 spread = SimdAnd(SimdShuffle(m, kBcastMant7), kBits);
+            m = SimdShuffle(SimdOr(m, SimdAnd(SimdCmpEq(spread, kBits), k80)), kPackMant7);
+            uint8_t packed[16];
+            SimdStore(packed, m);
+            memcpy(base + fs.mant7 + i / 8 * 7, packed, 14);
+
+            // low 16 mantissa bits
+            SimdStore(base + fs.mant16hi + i, FieldEncode(kFieldDeltaMant16, b[1], prevHi));
+            SimdStore(base + fs.mant16lo + i, FieldEncode(kFieldDeltaMant16, b[0], prevLo));
+            prevHi = b[1];
+            prevLo = b[0];
+        }
+        if (i < n8)
+        {
+            // last group of 8
+            uint8_t pExp = SimdGetLane<15>(prevExp), pMant7 = SimdGetLane<15>(prevMant7);
+            uint8_t pHi = SimdGetLane<15>(prevHi), pLo = SimdGetLane<15>(prevLo);
+            uint8_t signs = 0, mant7[8];
+            for (int k = 0; k < 8; ++k)
+            {
+                uint32_t v;
+                memcpy(&v, srcPtr + (i + k) * channels, 4);
+                uint8_t e = uint8_t(v >> 23), m = (v >> 16) & 0x7F, hi = uint8_t(v >> 8), lo = uint8_t(v);
+                base[fs.exp + i + k] = FieldEncode(kFieldDeltaExp, e, pExp);
+                mant7[k] = FieldEncode(kFieldDeltaMant7, m, pMant7) & 0x7F;
+                base[fs.mant16hi + i + k] = FieldEncode(kFieldDeltaMant16, hi, pHi);
+                base[fs.mant16lo + i + k] = FieldEncode(kFieldDeltaMant16, lo, pLo);
+                pExp = e; pMant7 = m; pHi = hi; pLo = lo;
+                signs |= (v >> 31) << k;
+            }
+            base[fs.sign + i / 8] = FieldEncode(kFieldDeltaSign, signs, prevSign);
+            for (int k = 0; k < 7; ++k)
+                base[fs.mant7 + i / 8 * 7 + k] = mant7[k] | (((mant7[7] >> k) & 1) << 7);
+        }
+    }
+    memcpy(dst + n8 * channels, src + n8 * channels, (dataElems - n8) * channels);
+}
+
+void UnFilter_L(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems)
+{
+    if ((channels & 3) != 0)
+    {
+        UnFilter_H(src, dst, channels, dataElems);
+        return;
+    }
+    const size_t n8 = dataElems & ~size_t(7);
+    const FieldStreams fs(n8);
+    const Bytes16 kSplit = SimdLoad(kFieldSplitTable);
+    const Bytes16 kBits = SimdLoad(kFieldBitTable);
+    const Bytes16 kBcastSign = SimdLoad(kFieldBcastSignTable);
+    const Bytes16 kUnpackMant7 = SimdLoad(kFieldUnpackMant7Table);
+    const Bytes16 kLast = SimdSet1(15);
+    const Bytes16 k7F = SimdSet1(0x7F), k80 = SimdSet1(0x80);
+    for (int fi = 0; fi < channels / 4; ++fi)
+    {
+        const uint8_t* base = src + fi * n8 * 4;
+        uint8_t* dstPtr = dst + fi * 4;
+        Bytes16 prevExp = SimdZero(), prevMant7 = SimdZero(), prevHi = SimdZero(), prevLo = SimdZero();
+        uint8_t prevSign = 0;
+        size_t i = 0;
+        for (; i + 16 <= n8; i += 16)
+        {
+            Bytes16 exp = FieldDecode(kFieldDeltaExp, SimdLoad(base + fs.exp + i), prevExp);
+            prevExp = SimdShuffle(exp, kLast);
+            uint8_t s0 = FieldDecode(kFieldDeltaSign, base[fs.sign + i / 8], prevSign);
+            uint8_t s1 = FieldDecode(kFieldDeltaSign, base[fs.sign + i / 8 + 1], s0);
+            prevSign = s1;
+            Bytes16 signs = SimdShuffle(SimdSet1U32(s0 | (s1 << 8)), kBcastSign);
+            signs = SimdAnd(SimdCmpEq(SimdAnd(signs, kBits), kBits), k80);
+
+            // gather top bits back into lanes 7 and 15
+            uint8_t packed[16];
+            memcpy(packed, base + fs.mant7 + i / 8 * 7, 14);
+            Bytes16 m = SimdShuffle(SimdLoad(packed), kUnpackMant7);
+            uint32_t topBits = SimdMoveMask(m);
+            m = SimdAnd(m, k7F);
+            m = SimdSetLane<7>(m, topBits & 0x7F);
+            m = SimdSetLane<15>(m, (topBits >> 8) & 0x7F);
+            Bytes16 mant7 = SimdAnd(FieldDecode(kFieldDeltaMant7, m, prevMant7), k7F);
+            prevMant7 = SimdShuffle(mant7, kLast);
+
+            Bytes16 b[4];
+            b[0] = FieldDecode(kFieldDeltaMant16, SimdLoad(base + fs.mant16lo + i), prevLo);
+            b[1] = FieldDecode(kFieldDeltaMant16, SimdLoad(base + fs.mant16hi + i), prevHi);
+            prevLo = SimdShuffle(b[0], kLast);
+            prevHi = SimdShuffle(b[1], kLast);
+            b[2] = SimdOr(SimdAnd(SimdShiftLeftU32(exp, 7), k80), mant7);
+            b[3] = SimdOr(signs, SimdAnd(SimdShiftRightU32(exp, 1), k7F));
+            UnSplitBytes4x16(b, kSplit);
+
+            uint32_t vals[16];
+            for (int k = 0; k < 4; ++k)
+                SimdStore(vals + k * 4, b[k]);
+            for (int k = 0; k < 16; ++k)
+                memcpy(dstPtr + (i + k) * channels, &vals[k], 4);
+        }
+        if (i < n8)
+        {
+            uint8_t pExp = SimdGetLane<15>(prevExp), pMant7 = SimdGetLane<15>(prevMant7);
+            uint8_t pHi = SimdGetLane<15>(prevHi), pLo = SimdGetLane<15>(prevLo);
+            uint8_t signs = FieldDecode(kFieldDeltaSign, base[fs.sign + i / 8], prevSign);
+            const uint8_t* packed = base + fs.mant7 + i / 8 * 7;
+            uint8_t mant7[8] = {};
+            for (int k = 0; k < 7; ++k)
+            {
+                mant7[k] = packed[k] & 0x7F;
+                mant7[7] |= (packed[k] >> 7) << k;
+            }
+            for (int k = 0; k < 8; ++k)
+            {
+                pExp = FieldDecode(kFieldDeltaExp, base[fs.exp + i + k], pExp);
+                pMant7 = FieldDecode(kFieldDeltaMant7, mant7[k], pMant7) & 0x7F;
+                pHi = FieldDecode(kFieldDeltaMant16, base[fs.mant16hi + i + k], pHi);
+                pLo = FieldDecode(kFieldDeltaMant16, base[fs.mant16lo + i + k], pLo);
+                uint32_t v = (uint32_t((signs >> k) & 1) << 31) | (uint32_t(pExp) << 23) | (uint32_t(pMant7) << 16) | (uint32_t(pHi) << 8) | pLo;
+                memcpy(dstPtr + (i + k) * channels, &v, 4);
+            }
+        }
+    }
+    memcpy(dst + n8 * channels, src + n8 * channels, (dataElems - n8) * channels);
+}
+
+// Cross channel decorrelation, done on 32 bit integers of each element, before byte split + delta.
+
+// masks of u32 lanes where channel index within element is >= minIndex; element
+// boundaries repeat every "phases" vectors
+static int CrossChannelMasks(int floats, int minIndex, Bytes16* masks)
+{
+    const int phases = (floats & 3) == 0 ? floats / 4 : (floats & 1) == 0 ? floats / 2 : floats;
+    for (int p = 0; p < phases; ++p)
+    {
+        uint32_t m[4];
+        for (int j = 0; j < 4; ++j)
+            m[j] = (p * 4 + j) % floats >= minIndex ? ~0u : 0;
+        masks[p] = SimdLoad(m);
+    }
+    return phases;
+}
+
+// channel k minus channel k-1
+static void CrossChannelEncodePrev(const uint32_t* src, uint32_t* dst, int floats, size_t count)
+{
+    Bytes16 masks[kMaxChannels / 4];
+    const int phases = CrossChannelMasks(floats, 1, masks);
+    Bytes16 prev = SimdZero();
+    int phase = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        Bytes16 v = SimdLoad(src + i);
+        SimdStore(dst + i, SimdSubU32(v, SimdAnd(SimdConcat<12>(v, prev), masks[phase])));
+        prev = v;
+        if (++phase == phases)
+            phase = 0;
+    }
+    for (; i < count; ++i)
+        dst[i] = i % floats != 0 ? src[i] - src[i - 1] : src[i];
+}
+
+// prefix sum within each element; can work in place
+static void CrossChannelDecodePrev(const uint32_t* src, uint32_t* dst, int floats, size_t count)
+{
+    size_t i = 0;
+    if (floats == 4)
+    {
+        for (; i + 4 <= count; i += 4)
+        {
+            Bytes16 x = SimdLoad(src + i);
+            x = SimdAddU32(x, SimdConcat<12>(x, SimdZero()));
+            x = SimdAddU32(x, SimdConcat<8>(x, SimdZero()));
+            SimdStore(dst + i, x);
+        }
+    }
+    else if (floats < 4)
+    {
+        // add masked one and two lanes shifted input; lanes shifted in come from previous
+        // input vector, not the already decoded output
+        Bytes16 masks1[3], masks2[3];
+        const int phases = CrossChannelMasks(floats, 1, masks1);
+        CrossChannelMasks(floats, 2, masks2);
+        Bytes16 prev = SimdZero();
+        int phase = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            Bytes16 d = SimdLoad(src + i);
+            Bytes16 x = SimdAddU32(d, SimdAnd(SimdConcat<12>(d, prev), masks1[phase]));
+            x = SimdAddU32(x, SimdAnd(SimdConcat<8>(d, prev), masks2[phase]));
+            SimdStore(dst + i, x);
+            prev = d;
+            if (++phase == phases)
+                phase = 0;
+        }
+    }
+    for (; i < count; ++i)
+        dst[i] = i % floats != 0 ? src[i] + dst[i - 1] : src[i];
+}
+
+// every channel except the reference one minus the reference channel; can work in place
+template<bool Decode>
+static void CrossChannelRef(const uint32_t* src, uint32_t* dst, int floats, int ref, size_t dataElems)
+{
+    size_t e = 0;
+    if (floats == 4)
+    {
+        uint8_t bcastTable[16];
+        uint32_t mask[4];
+        for (int j = 0; j < 16; ++j)
+            bcastTable[j] = uint8_t(ref * 4 + (j & 3));
+        for (int j = 0; j < 4; ++j)
+            mask[j] = j != ref ? ~0u : 0;
+        const Bytes16 kBcast = SimdLoad(bcastTable);
+        const Bytes16 kMask = SimdLoad(mask);
+        for (; e < dataElems; ++e)
+        {
+            Bytes16 v = SimdLoad(src + e * 4);
+            Bytes16 r = SimdAnd(SimdShuffle(v, kBcast), kMask);
+            SimdStore(dst + e * 4, Decode ? SimdAddU32(v, r) : SimdSubU32(v, r));
+        }
+    }
+    for (; e < dataElems; ++e)
+    {
+        const uint32_t* s = src + e * floats;
+        uint32_t* d = dst + e * floats;
+        const uint32_t r = s[ref];
+        for (int k = 0; k < floats; ++k)
+            d[k] = k == ref ? r : Decode ? s[k] + r : s[k] - r;
+    }
+}
+
+static bool CanCrossChannel(int channels, int refChannel)
+{
+    return (channels & 3) == 0 && channels >= 8 && refChannel < channels / 4;
+}
+
+void Filter_CrossChannel(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems, int refChannel)
+{
+    if (!CanCrossChannel(channels, refChannel))
+    {
+        Filter_H(src, dst, channels, dataElems);
+        return;
+    }
+    const int floats = channels / 4;
+    std::vector<uint32_t> tmp(dataElems * floats);
+    if (refChannel < 0)
+        CrossChannelEncodePrev((const uint32_t*)src, tmp.data(), floats, dataElems * floats);
+    else
+        CrossChannelRef<false>((const uint32_t*)src, tmp.data(), floats, refChannel, dataElems);
+    Filter_H((const uint8_t*)tmp.data(), dst, channels, dataElems);
+}
+
+void UnFilter_CrossChannel(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems, int refChannel)
+{
+    if (!CanCrossChannel(channels, refChannel))
+    {
+        UnFilter_H(src, dst, channels, dataElems);
+        return;
+    }
+    UnFilter_K(src, dst, channels, dataElems);
+    const int floats = channels / 4;
+    uint32_t* data = (uint32_t*)dst;
+    if (refChannel < 0)
+        CrossChannelDecodePrev(data, data, floats, dataElems * floats);
+    else
+        CrossChannelRef<true>(data, data, floats, refChannel, dataElems);
+}
+
+void Filter_M(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems)
+{
+    Filter_CrossChannel(src, dst, channels, dataElems, -1);
+}
+
+void UnFilter_M(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems)
+{
+    UnFilter_CrossChannel(src, dst, channels, dataElems, -1);
+}
+
+void Filter_N(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems)
+{
+    Filter_CrossChannel(src, dst, channels, dataElems, 0);
+}
+
+void UnFilter_N(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems)
+{
+    UnFilter_CrossChannel(src, dst, channels, dataElems, 0);
+}
+
+
 
 void Filter_Shuffle(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems)
 {
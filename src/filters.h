@@ -41,3 +41,19 @@ void UnFilter_J(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems
 // Fetch from groups of 4 channels, interleave and store to stack. Then interleave these groups, undelta and store.
 void UnFilter_K(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems);
 
+// Split float sign+exponent / high 7 mantissa bits / low 16 mantissa bits into separate streams,
+// with delta chosen per stream. Strides that are not a multiple of 4 bytes fall back to H.
+void Filter_L(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems);
+void UnFilter_L(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems);
+
+// Cross channel decorrelation: within each element, 32 bit channel k is replaced by its integer
+// difference from channel k-1 (refChannel < 0) or from refChannel, then split + delta like H.
+// Strides that are not a multiple of 4 bytes, or with a single float, fall back to H.
+void Filter_CrossChannel(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems, int refChannel);
+void UnFilter_CrossChannel(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems, int refChannel);
+// cross channel: from previous channel
+void Filter_M(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems);
+void UnFilter_M(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems);
+// cross channel: from channel 0
+void Filter_N(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems);
+void UnFilter_N(const uint8_t* src, uint8_t* dst, int channels, size_t dataElems);
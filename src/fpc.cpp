@@ -0,0 +1,174 @@
+#include "fpc.h"
+#include "parallel.h"
+#include <bit>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+// elements per chunk; each chunk is independent (own predictor tables)
+static const size_t kFpcChunkElems = 64 * 1024;
+
+struct FpcHeader
+{
+    uint32_t tableBits;
+    uint32_t chunkCount;
+    // followed by uint32_t chunk sizes, then chunk data
+};
+
+struct FpcPredictor
+{
+    std::vector<uint32_t> fcm, dfcm;
+    uint32_t mask = 0, h1 = 0, h2 = 0, last = 0;
+
+    void Reset(int tableBits)
+    {
+        size_t size = size_t(1) << tableBits;
+        fcm.assign(size, 0);
+        dfcm.assign(size, 0);
+        mask = uint32_t(size - 1);
+        h1 = h2 = last = 0;
+    }
+    void Update(uint32_t v)
+    {
+        uint32_t d = v - last;
+        fcm[h1] = v;
+        h1 = ((h1 << 6) ^ (v >> 20)) & mask;
+        dfcm[h2] = d;
+        h2 = ((h2 << 2) ^ (d >> 20)) & mask;
+        last = v;
+    }
+};
+
+static size_t FpcStreamBound(size_t count)
+{
+    // 4 bit header and up to 4 bytes per value, plus slack for 4 byte stores
+    return (count + 1) / 2 + count * 4 + 4;
+}
+
+static size_t FpcChunkBound(size_t count, int channels)
+{
+    return channels * (4 + FpcStreamBound(count));
+}
+
+// header nibble: bit 3 = DFCM predictor used, bits 0-2 = leading zero bytes of residual (0..4)
+static size_t FpcEncodeStream(const uint32_t* src, size_t count, int stride, FpcPredictor& pred, uint8_t* dst)
+{
+    uint8_t* hdr = dst;
+    uint8_t* out = dst + (count + 1) / 2;
+    memset(hdr, 0, (count + 1) / 2);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t v = src[i * stride];
+        uint32_t x1 = v ^ pred.fcm[pred.h1];
+        uint32_t x2 = v ^ (pred.dfcm[pred.h2] + pred.last);
+        pred.Update(v);
+        uint32_t sel = x2 < x1 ? 1 : 0;
+        uint32_t x = sel ? x2 : x1;
+        uint32_t lzb = std::countl_zero(x) >> 3;
+        hdr[i >> 1] |= uint8_t(((sel << 3) | lzb) << ((i & 1) * 4));
+        memcpy(out, &x, 4);
+        out += 4 - lzb;
+    }
+    return out - dst;
+}
+
+static const uint32_t kFpcByteMask[5] = { 0xFFFFFFFF, 0x00FFFFFF, 0x0000FFFF, 0x000000FF, 0 };
+
+static void FpcDecodeStream(const uint8_t* src, size_t srcSize, uint32_t* dst, size_t count, int stride, FpcPredictor& pred)
+{
+    const uint8_t* hdr = src;
+    const uint8_t* in = src + (count + 1) / 2;
+    const uint8_t* inEnd = src + srcSize;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t code = (hdr[i >> 1] >> ((i & 1) * 4)) & 15;
+        uint32_t lzb = code & 7;
+        uint32_t x = 0;
+        // last few values of a stream can not do a full 4 byte load
+        if (in + 4 <= inEnd)
+            memcpy(&x, in, 4);
+        else
+            memcpy(&x, in, 4 - lzb);
+        x &= kFpcByteMask[lzb];
+        in += 4 - lzb;
+        uint32_t p = (code & 8) ? pred.dfcm[pred.h2] + pred.last : pred.fcm[pred.h1];
+        uint32_t v = x ^ p;
+        pred.Update(v);
+        dst[i * stride] = v;
+    }
+}
+
+size_t fpc_compress_bound(size_t dataElems, int channels)
+{
+    size_t chunkCount = (dataElems + kFpcChunkElems - 1) / kFpcChunkElems;
+    return sizeof(FpcHeader) + chunkCount * 4 + chunkCount * FpcChunkBound(kFpcChunkElems, channels);
+}
+
+size_t fpc_compress(const float* src, size_t dataElems, int channels, int tableBits, int threadCount, uint8_t* dst)
+{
+    int chunkCount = int((dataElems + kFpcChunkElems - 1) / kFpcChunkElems);
+    FpcHeader* hdr = (FpcHeader*)dst;
+    hdr->tableBits = tableBits;
+    hdr->chunkCount = chunkCount;
+    uint32_t* chunkSizes = (uint32_t*)(dst + sizeof(FpcHeader));
+
+    threadCount = std::min(threadCount > 0 ? threadCount : GetHardwareThreadCount(), std::max(chunkCount, 1));
+    std::vector<FpcPredictor> preds(threadCount);
+    const size_t chunkBound = FpcChunkBound(kFpcChunkElems, channels);
+    std::vector<uint8_t> tmp(chunkCount * chunkBound);
+    ParallelFor(chunkCount, threadCount, [&](int ic, int it)
+    {
+        size_t start = ic * kFpcChunkElems;
+        size_t count = std::min(kFpcChunkElems, dataElems - start);
+        uint8_t* out = tmp.data() + ic * chunkBound;
+        uint32_t* streamSizes = (uint32_t*)out;
+        out += channels * 4;
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            preds[it].Reset(tableBits);
+            size_t size = FpcEncodeStream((const uint32_t*)src + start * channels + ch, count, channels, preds[it], out);
+            streamSizes[ch] = uint32_t(size);
+            out += size;
+        }
+        chunkSizes[ic] = uint32_t(out - (tmp.data() + ic * chunkBound));
+    });
+
+    uint8_t* out = dst + sizeof(FpcHeader) + chunkCount * 4;
+    for (int ic = 0; ic < chunkCount; ++ic)
+    {
+        memcpy(out, tmp.data() + ic * chunkBound, chunkSizes[ic]);
+        out += chunkSizes[ic];
+    }
+    return out - dst;
+}
+
+void fpc_decompress(const uint8_t* src, size_t srcSize, float* dst, size_t dataElems, int channels, int threadCount)
+{
+    const FpcHeader* hdr = (const FpcHeader*)src;
+    int chunkCount = hdr->chunkCount;
+    const uint32_t* chunkSizes = (const uint32_t*)(src + sizeof(FpcHeader));
+    std::vector<size_t> chunkOffsets(chunkCount);
+    size_t offset = sizeof(FpcHeader) + chunkCount * 4;
+    for (int ic = 0; ic < chunkCount; ++ic)
+    {
+        chunkOffsets[ic] = offset;
+        offset += chunkSizes[ic];
+    }
+
+    threadCount = std::min(threadCount > 0 ? threadCount : GetHardwareThreadCount(), std::max(chunkCount, 1));
+    std::vector<FpcPredictor> preds(threadCount);
+    ParallelFor(chunkCount, threadCount, [&](int ic, int it)
+    {
+        size_t start = ic * kFpcChunkElems;
+        size_t count = std::min(kFpcChunkElems, dataElems - start);
+        const uint8_t* in = src + chunkOffsets[ic];
+        const uint32_t* streamSizes = (const uint32_t*)in;
+        in += channels * 4;
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            preds[it].Reset(hdr->tableBits);
+            FpcDecodeStream(in, streamSizes[ch], (uint32_t*)dst + start * channels + ch, count, channels, preds[it]);
+            in += streamSizes[ch];
+        }
+    });
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// FPC style (Burtscher & Ratanaworabhan 2009) codec, float32 flavor: each value is
+// predicted by an FCM (hash of previous values) and a DFCM (hash of previous deltas)
+// table, XORed with the closer prediction, and stored as 4 bit header (predictor
+// selector + leading zero byte count) followed by the non-zero bytes.
+// Input is split into independent chunks that are coded on worker threads; within a
+// chunk each channel of interleaved data is its own stream.
+// tableBits: log2 of predictor table entry count.
+size_t fpc_compress_bound(size_t dataElems, int channels);
+size_t fpc_compress(const float* src, size_t dataElems, int channels, int tableBits, int threadCount, uint8_t* dst);
+void fpc_decompress(const uint8_t* src, size_t srcSize, float* dst, size_t dataElems, int channels, int threadCount);
@@ -0,0 +1,331 @@
+#include "halffloat.h"
+#include "simd.h"
+#include <string.h>
+
+#if CPU_ARCH_X64
+#   include <immintrin.h>
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#       define F16C_TARGET
+static bool HasF16C() { int info[4]; __cpuid(info, 1); return (info[2] & (1 << 29)) != 0; }
+#   else
+#       define F16C_TARGET __attribute__((target("f16c")))
+static bool HasF16C() { return __builtin_cpu_supports("f16c"); }
+#   endif
+static const bool s_HasF16C = HasF16C();
+#endif
+
+// scalar conversions, https://gist.github.com/rygorous/2156668
+static inline uint16_t FloatToHalf(uint32_t f)
+{
+    const uint32_t f32infty = 255 << 23;
+    const uint32_t f16max = (127 + 16) << 23;
+    const uint32_t denormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+    uint32_t sign = f & 0x80000000u;
+    f ^= sign;
+    uint16_t o;
+    if (f >= f16max) // result is Inf or NaN
+        o = (f > f32infty) ? 0x7e00 : 0x7c00;
+    else if (f < (113 << 23)) // resulting fp16 is subnormal or zero
+    {
+        float ff, magic;
+        memcpy(&ff, &f, 4);
+        memcpy(&magic, &denormMagic, 4);
+        ff += magic;
+        memcpy(&f, &ff, 4);
+        o = uint16_t(f - denormMagic);
+    }
+    else
+    {
+        uint32_t mantOdd = (f >> 13) & 1;
+        f += ((15 - 127) << 23) + 0xfff;
+        f += mantOdd;
+        o = uint16_t(f >> 13);
+    }
+    return o | uint16_t(sign >> 16);
+}
+
+static inline uint32_t HalfToFloat(uint16_t h)
+{
+    const uint32_t shiftedExp = 0x7c00 << 13;
+    uint32_t o = (h & 0x7fff) << 13;
+    uint32_t exp = shiftedExp & o;
+    o += (127 - 15) << 23;
+    if (exp == shiftedExp) // Inf / NaN
+        o += (128 - 16) << 23;
+    else if (exp == 0) // zero / subnormal
+    {
+        const uint32_t magicBits = 113 << 23;
+        float of, magic;
+        o += 1 << 23;
+        memcpy(&of, &o, 4);
+        memcpy(&magic, &magicBits, 4);
+        of -= magic;
+        memcpy(&o, &of, 4);
+    }
+    return o | ((h & 0x8000) << 16);
+}
+
+static inline uint16_t FloatToBf16(uint32_t f)
+{
+    if ((f & 0x7fffffff) > 0x7f800000) // NaN: keep it NaN
+        return uint16_t((f >> 16) | 0x40);
+    return uint16_t((f + 0x7fff + ((f >> 16) & 1)) >> 16);
+}
+
+// gathers 4 values of a channel into a vector
+#if CPU_ARCH_X64
+static inline __m128i Gather4(const float* src, int channels)
+{
+    if (channels == 1)
+        return _mm_loadu_si128((const __m128i*)src);
+    const uint32_t* s = (const uint32_t*)src;
+    return _mm_setr_epi32(s[0], s[channels], s[channels * 2], s[channels * 3]);
+}
+
+F16C_TARGET static void PackFp16F16C(const float* src, int channels, size_t dataElems, uint16_t* dst)
+{
+    size_t i = 0;
+    for (; i + 8 <= dataElems; i += 8)
+    {
+        __m128 a = _mm_castsi128_ps(Gather4(src + i * channels, channels));
+        __m128 b = _mm_castsi128_ps(Gather4(src + (i + 4) * channels, channels));
+        __m128i ha = _mm_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT);
+        __m128i hb = _mm_cvtps_ph(b, _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi64(ha, hb));
+    }
+    const uint32_t* s = (const uint32_t*)src;
+    for (; i < dataElems; ++i)
+        dst[i] = FloatToHalf(s[i * channels]);
+}
+
+F16C_TARGET static void UnpackFp16F16C(const uint16_t* src, size_t dataElems, float* dst, int channels)
+{
+    size_t i = 0;
+    for (; i + 8 <= dataElems; i += 8)
+    {
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128 a = _mm_cvtph_ps(h);
+        __m128 b = _mm_cvtph_ps(_mm_unpackhi_epi64(h, h));
+        if (channels == 1)
+        {
+            _mm_storeu_ps(dst + i, a);
+            _mm_storeu_ps(dst + i + 4, b);
+        }
+        else
+        {
+            float tmp[8];
+            _mm_storeu_ps(tmp, a);
+            _mm_storeu_ps(tmp + 4, b);
+            for (int j = 0; j < 8; ++j)
+                dst[(i + j) * channels] = tmp[j];
+        }
+    }
+    uint32_t* d = (uint32_t*)dst;
+    for (; i < dataElems; ++i)
+        d[i * channels] = HalfToFloat(src[i]);
+}
+
+static void PackBf16(const float* src, int channels, size_t dataElems, uint16_t* dst)
+{
+    const __m128i kExpMask = _mm_set1_epi32(0x7f800000);
+    const __m128i kAbsMask = _mm_set1_epi32(0x7fffffff);
+    const __m128i kRound = _mm_set1_epi32(0x7fff);
+    const __m128i kOne = _mm_set1_epi32(1);
+    const __m128i kQuiet = _mm_set1_epi32(0x400000);
+    size_t i = 0;
+    for (; i + 8 <= dataElems; i += 8)
+    {
+        __m128i r[2];
+        for (int k = 0; k < 2; ++k)
+        {
+            __m128i v = Gather4(src + (i + k * 4) * channels, channels);
+            __m128i nan = _mm_cmpgt_epi32(_mm_and_si128(v, kAbsMask), kExpMask);
+            __m128i rounded = _mm_add_epi32(v, _mm_add_epi32(kRound, _mm_and_si128(_mm_srli_epi32(v, 16), kOne)));
+            rounded = _mm_or_si128(_mm_andnot_si128(nan, rounded), _mm_and_si128(nan, _mm_or_si128(v, kQuiet)));
+            r[k] = _mm_srli_epi32(rounded, 16);
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi32(r[0], r[1]));
+    }
+    const uint32_t* s = (const uint32_t*)src;
+    for (; i < dataElems; ++i)
+        dst[i] = FloatToBf16(s[i * channels]);
+}
+
+static void UnpackBf16(const uint16_t* src, size_t dataElems, float* dst, int channels)
+{
+    size_t i = 0;
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= dataElems; i += 8)
+    {
+        __m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i a = _mm_unpacklo_epi16(zero, h);
+        __m128i b = _mm_unpackhi_epi16(zero, h);
+        if (channels == 1)
+        {
+            _mm_storeu_si128((__m128i*)(dst + i), a);
+            _mm_storeu_si128((__m128i*)(dst + i + 4), b);
+        }
+        else
+        {
+            uint32_t tmp[8];
+            _mm_storeu_si128((__m128i*)tmp, a);
+            _mm_storeu_si128((__m128i*)(tmp + 4), b);
+            uint32_t* d = (uint32_t*)dst;
+            for (int j = 0; j < 8; ++j)
+                d[(i + j) * channels] = tmp[j];
+        }
+    }
+    uint32_t* d = (uint32_t*)dst;
+    for (; i < dataElems; ++i)
+        d[i * channels] = uint32_t(src[i]) << 16;
+}
+
+#elif CPU_ARCH_ARM64
+
+static inline uint32x4_t Gather4(const float* src, int channels)
+{
+    if (channels == 1)
+        return vld1q_u32((const uint32_t*)src);
+    const uint32_t* s = (const uint32_t*)src;
+    uint32_t tmp[4] = { s[0], s[channels], s[channels * 2], s[channels * 3] };
+    return vld1q_u32(tmp);
+}
+
+static void PackFp16Neon(const float* src, int channels, size_t dataElems, uint16_t* dst)
+{
+    size_t i = 0;
+    for (; i + 8 <= dataElems; i += 8)
+    {
+        float16x4_t a = vcvt_f16_f32(vreinterpretq_f32_u32(Gather4(src + i * channels, channels)));
+        float16x4_t b = vcvt_f16_f32(vreinterpretq_f32_u32(Gather4(src + (i + 4) * channels, channels)));
+        vst1q_u16(dst + i, vreinterpretq_u16_f16(vcombine_f16(a, b)));
+    }
+    const uint32_t* s = (const uint32_t*)src;
+    for (; i < dataElems; ++i)
+        dst[i] = FloatToHalf(s[i * channels]);
+}
+
+static void UnpackFp16Neon(const uint16_t* src, size_t dataElems, float* dst, int channels)
+{
+    size_t i = 0;
+    for (; i + 8 <= dataElems; i += 8)
+    {
+        float16x8_t h = vreinterpretq_f16_u16(vld1q_u16(src + i));
+        float32x4_t a = vcvt_f32_f16(vget_low_f16(h));
+        float32x4_t b = vcvt_f32_f16(vget_high_f16(h));
+        if (channels == 1)
+        {
+            vst1q_f32(dst + i, a);
+            vst1q_f32(dst + i + 4, b);
+        }
+        else
+        {
+            float tmp[8];
+            vst1q_f32(tmp, a);
+            vst1q_f32(tmp + 4, b);
+            for (int j = 0; j < 8; ++j)
+                dst[(i + j) * channels] = tmp[j];
+        }
+    }
+    uint32_t* d = (uint32_t*)dst;
+    for (; i < dataElems; ++i)
+        d[i * channels] = HalfToFloat(src[i]);
+}
+
+static void PackBf16(const float* src, int channels, size_t dataElems, uint16_t* dst)
+{
+    const uint32x4_t kExpMask = vdupq_n_u32(0x7f800000);
+    const uint32x4_t kAbsMask = vdupq_n_u32(0x7fffffff);
+    const uint32x4_t kRound = vdupq_n_u32(0x7fff);
+    const uint32x4_t kOne = vdupq_n_u32(1);
+    const uint32x4_t kQuiet = vdupq_n_u32(0x400000);
+    size_t i = 0;
+    for (; i + 8 <= dataElems; i += 8)
+    {
+        uint16x4_t r[2];
+        for (int k = 0; k < 2; ++k)
+        {
+            uint32x4_t v = Gather4(src + (i + k * 4) * channels, channels);
+            uint32x4_t nan = vcgtq_u32(vandq_u32(v, kAbsMask), kExpMask);
+            uint32x4_t rounded = vaddq_u32(v, vaddq_u32(kRound, vandq_u32(vshrq_n_u32(v, 16), kOne)));
+            rounded = vbslq_u32(nan, vorrq_u32(v, kQuiet), rounded);
+            r[k] = vshrn_n_u32(rounded, 16);
+        }
+        vst1q_u16(dst + i, vcombine_u16(r[0], r[1]));
+    }
+    const uint32_t* s = (const uint32_t*)src;
+    for (; i < dataElems; ++i)
+        dst[i] = FloatToBf16(s[i * channels]);
+}
+
+static void UnpackBf16(const uint16_t* src, size_t dataElems, float* dst, int channels)
+{
+    size_t i = 0;
+    for (; i + 8 <= dataElems; i += 8)
+    {
+        uint16x8_t h = vld1q_u16(src + i);
+        uint32x4_t a = vshll_n_u16(vget_low_u16(h), 16);
+        uint32x4_t b = vshll_n_u16(vget_high_u16(h), 16);
+        if (channels == 1)
+        {
+            vst1q_u32((uint32_t*)dst + i, a);
+            vst1q_u32((uint32_t*)dst + i + 4, b);
+        }
+        else
+        {
+            uint32_t tmp[8];
+            vst1q_u32(tmp, a);
+            vst1q_u32(tmp + 4, b);
+            uint32_t* d = (uint32_t*)dst;
+            for (int j = 0; j < 8; ++j)
+                d[(i + j) * channels] = tmp[j];
+        }
+    }
+    uint32_t* d = (uint32_t*)dst;
+    for (; i < dataElems; ++i)
+        d[i * channels] = uint32_t(src[i]) << 16;
+}
+#endif
+
+void half_pack_channel(const float* src, int channels, size_t dataElems, HalfFormat format, uint16_t* dst)
+{
+    if (format == kHalfBf16)
+    {
+        PackBf16(src, channels, dataElems, dst);
+        return;
+    }
+#if CPU_ARCH_X64
+    if (s_HasF16C)
+    {
+        PackFp16F16C(src, channels, dataElems, dst);
+        return;
+    }
+    const uint32_t* s = (const uint32_t*)src;
+    for (size_t i = 0; i < dataElems; ++i)
+        dst[i] = FloatToHalf(s[i * channels]);
+#elif CPU_ARCH_ARM64
+    PackFp16Neon(src, channels, dataElems, dst);
+#endif
+}
+
+void half_unpack_channel(const uint16_t* src, size_t dataElems, HalfFormat format, float* dst, int channels)
+{
+    if (format == kHalfBf16)
+    {
+        UnpackBf16(src, dataElems, dst, channels);
+        return;
+    }
+#if CPU_ARCH_X64
+    if (s_HasF16C)
+    {
+        UnpackFp16F16C(src, dataElems, dst, channels);
+        return;
+    }
+    uint32_t* d = (uint32_t*)dst;
+    for (size_t i = 0; i < dataElems; ++i)
+        d[i * channels] = HalfToFloat(src[i]);
+#elif CPU_ARCH_ARM64
+    UnpackFp16Neon(src, dataElems, dst, channels);
+#endif
+}
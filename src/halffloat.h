@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// float32 <-> 16 bit float conversions, round to nearest even:
+// - fp16: IEEE half (F16C on x64 when the CPU has it, NEON on ARM64, scalar otherwise),
+// - bf16: upper 16 bits of float32 (SSE2 / NEON integer ops).
+// Work on one channel of interleaved float data, so that the 16 bit values end up
+// contiguous.
+enum HalfFormat
+{
+    kHalfFp16,
+    kHalfBf16,
+};
+
+void half_pack_channel(const float* src, int channels, size_t dataElems, HalfFormat format, uint16_t* dst);
+void half_unpack_channel(const uint16_t* src, size_t dataElems, HalfFormat format, float* dst, int channels);
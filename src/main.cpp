@@ -4,6 +4,9 @@
 #include "compressors.h"
 #include "compression_helpers.h"
 #include "filters.h"
+#include "channeldict.h"
+#include "morton.h"
+#include "bitround.h"
 #include "systeminfo.h"
 #include "resultcache.h"
 #include <set>
@@ -35,6 +38,9 @@ static FilterDesc g_Filters[] =
 	{ "I-16x16", Filter_H, UnFilter_I },
 	{ "J-256xCh", Filter_H, UnFilter_J },
 	{ "K-384xCh-4x", Filter_H, UnFilter_K },
+	{ "L-fields", Filter_L, UnFilter_L },
+	{ "M-xchPrev", Filter_M, UnFilter_M },
+	{ "N-xchRef0", Filter_N, UnFilter_N },
 };
 constexpr int kFilterCount = sizeof(g_Filters) / sizeof(g_Filters[0]);
 
@@ -42,12 +48,44 @@ static FilterDesc g_FilterSplit8 = { "-s8", Filter_Shuffle, UnFilter_Shuffle };
 static FilterDesc g_FilterSplit8AndDeltaDiff = {"-s8dA", Filter_A, UnFilter_A }; // part 3 / part 6 beginning
 static FilterDesc g_FilterSplit8Delta = { "-s8dD", Filter_D, UnFilter_D }; // part 6 end
 static FilterDesc g_FilterSplit8DeltaOpt = { "-s8d", Filter_H, UnFilter_K };
+static FilterDesc g_FilterFieldSplit = { "-fs", Filter_L, UnFilter_L }; // sign+exponent / mantissa fields
+static FilterDesc g_FilterCrossChannel = { "-xc", Filter_M, UnFilter_M }; // channel minus previous channel, then split + delta
+static FilterDesc g_FilterCrossChannelRef0 = { "-xc0", Filter_N, UnFilter_N }; // channel minus first channel, then split + delta
+
+// lossy mantissa rounding before everything else; same parameter for all channels
+struct PrefilterDesc
+{
+	const char* name;
+	RoundMode mode;
+	int param; // mantissa bits or decimal digits to keep
+};
+static PrefilterDesc g_PrefilterGroom12 = { "-bg12", kRoundBitGroom, 12 };
+static PrefilterDesc g_PrefilterRound8 = { "-br8", kRoundBits, 8 };
+static PrefilterDesc g_PrefilterRound12 = { "-br12", kRoundBits, 12 };
+static PrefilterDesc g_PrefilterRound16 = { "-br16", kRoundBits, 16 };
+static PrefilterDesc g_PrefilterDigits3 = { "-dr3", kRoundDigits, 3 };
+static PrefilterDesc g_PrefilterDigits5 = { "-dr5", kRoundDigits, 5 };
 
 static std::unique_ptr<GenericCompressor> g_CompZstd = std::make_unique<GenericCompressor>(kCompressionZstd);
 static std::unique_ptr<GenericCompressor> g_CompLZ4 = std::make_unique<GenericCompressor>(kCompressionLZ4);
+static std::unique_ptr<GenericCompressor> g_CompZstdBypass = std::make_unique<GenericCompressor>(kCompressionZstd, true);
+static std::unique_ptr<GenericCompressor> g_CompLZ4Bypass = std::make_unique<GenericCompressor>(kCompressionLZ4, true);
 static std::unique_ptr<GenericCompressor> g_CompLZSSE8 = std::make_unique<GenericCompressor>(kCompressionLZSSE8);
+static std::unique_ptr<LZSSE8SegmentedCompressor> g_CompLZSSE8Seg = std::make_unique<LZSSE8SegmentedCompressor>(1024 * 1024, 0);
+static std::unique_ptr<LZSSE8SegmentedCompressor> g_CompLZSSE8SegT1 = std::make_unique<LZSSE8SegmentedCompressor>(1024 * 1024, 1);
+static std::unique_ptr<ChimpCompressor> g_CompGorilla = std::make_unique<ChimpCompressor>(false);
+static std::unique_ptr<ChimpCompressor> g_CompChimp128 = std::make_unique<ChimpCompressor>(true);
+static std::unique_ptr<AlpCompressor> g_CompAlp = std::make_unique<AlpCompressor>();
+static std::unique_ptr<FpcCompressor> g_CompFpc = std::make_unique<FpcCompressor>(0);
+static std::unique_ptr<FpcCompressor> g_CompFpcT1 = std::make_unique<FpcCompressor>(1);
 static std::unique_ptr<GenericCompressor> g_CompLizard1x = std::make_unique<GenericCompressor>(kCompressionLizard1x);
 static std::unique_ptr<GenericCompressor> g_CompLizard2x = std::make_unique<GenericCompressor>(kCompressionLizard2x);
+static std::unique_ptr<GenericCompressor> g_CompLizard3x = std::make_unique<GenericCompressor>(kCompressionLizard3x);
+static std::unique_ptr<GenericCompressor> g_CompLizard4x = std::make_unique<GenericCompressor>(kCompressionLizard4x);
+static std::unique_ptr<GenericCompressor> g_CompLizard1xStride = std::make_unique<GenericCompressor>(kCompressionLizard1x_Stride);
+static std::unique_ptr<GenericCompressor> g_CompLizard2xStride = std::make_unique<GenericCompressor>(kCompressionLizard2x_Stride);
+static std::unique_ptr<GenericCompressor> g_CompRans = std::make_unique<GenericCompressor>(kCompressionRans);
+static std::unique_ptr<GenericCompressor> g_CompHuff0 = std::make_unique<GenericCompressor>(kCompressionHuff0);
 #if BUILD_WITH_OODLE
 static std::unique_ptr<GenericCompressor> g_CompKraken = std::make_unique<GenericCompressor>(kCompressionOoodleKraken);
 static std::unique_ptr<GenericCompressor> g_CompSelkie = std::make_unique<GenericCompressor>(kCompressionOoodleSelkie);
@@ -67,15 +105,56 @@ static std::unique_ptr<GenericCompressor> g_CompBloscLZ4_ShufByteDelta = std::ma
 static std::unique_ptr<GenericCompressor> g_CompBloscZstd_ShufByteDelta = std::make_unique<GenericCompressor>(kCompressionBloscZstd_ShufByteDelta);
 
 static std::unique_ptr<Compressor> g_CompZfp = std::make_unique<ZfpCompressor>();
+static std::unique_ptr<Compressor> g_CompZfpAcc = std::make_unique<ZfpCompressor>(kZfpAccuracy);
+static std::unique_ptr<Compressor> g_CompZfpPrec = std::make_unique<ZfpCompressor>(kZfpPrecision);
+static std::unique_ptr<Compressor> g_CompZfpRate = std::make_unique<ZfpCompressor>(kZfpRate);
+static std::unique_ptr<Compressor> g_CompZfpOmp = std::make_unique<ZfpCompressor>(kZfpReversible, kZfpLayoutStrided, 0);
+static std::unique_ptr<Compressor> g_CompZfpPlanes = std::make_unique<ZfpCompressor>(kZfpReversible, kZfpLayoutPlanes, 0);
+static std::unique_ptr<Compressor> g_CompZfpPlanesT1 = std::make_unique<ZfpCompressor>(kZfpReversible, kZfpLayoutPlanes, 1);
+static std::unique_ptr<Compressor> g_CompZfpPlanesT2 = std::make_unique<ZfpCompressor>(kZfpReversible, kZfpLayoutPlanes, 2);
+static std::unique_ptr<Compressor> g_CompZfpChDim = std::make_unique<ZfpCompressor>(kZfpReversible, kZfpLayoutChannelDim, 1);
+static std::unique_ptr<Compressor> g_CompZfpAccPlanes = std::make_unique<ZfpCompressor>(kZfpAccuracy, kZfpLayoutPlanes, 0);
+static std::unique_ptr<Compressor> g_CompZfpAccChDim = std::make_unique<ZfpCompressor>(kZfpAccuracy, kZfpLayoutChannelDim, 1);
+static std::unique_ptr<Compressor> g_CompSzZstd = std::make_unique<SzCompressor>(kCompressionZstd, 0);
+static std::unique_ptr<Compressor> g_CompSzZstdT1 = std::make_unique<SzCompressor>(kCompressionZstd, 1);
+static std::unique_ptr<Compressor> g_CompSzHuff0 = std::make_unique<SzCompressor>(kCompressionHuff0, 0);
+static std::unique_ptr<Compressor> g_CompCm = std::make_unique<CmCompressor>(0);
+static std::unique_ptr<Compressor> g_CompCmT1 = std::make_unique<CmCompressor>(1);
+static std::unique_ptr<Compressor> g_CompHalfZstd = std::make_unique<HalfCompressor>(kCompressionZstd, kHalfFp16, ~0u);
+static std::unique_ptr<Compressor> g_CompHalfLZ4 = std::make_unique<HalfCompressor>(kCompressionLZ4, kHalfFp16, ~0u);
+static std::unique_ptr<Compressor> g_CompBf16Zstd = std::make_unique<HalfCompressor>(kCompressionZstd, kHalfBf16, ~0u);
+static std::unique_ptr<Compressor> g_CompHalfVelZstd = std::make_unique<HalfCompressor>(kCompressionZstd, kHalfFp16, 0xE); // water: velocity & pollution only
 static std::unique_ptr<Compressor> g_CompFpzip = std::make_unique<FpzipCompressor>();
+static std::unique_ptr<Compressor> g_CompFpzipB64T1 = std::make_unique<FpzipCompressor>(64, 1);
+static std::unique_ptr<Compressor> g_CompFpzipB64T2 = std::make_unique<FpzipCompressor>(64, 2);
+static std::unique_ptr<Compressor> g_CompFpzipB64T4 = std::make_unique<FpzipCompressor>(64, 4);
+static std::unique_ptr<Compressor> g_CompFpzipB64 = std::make_unique<FpzipCompressor>(64, 0);
 static std::unique_ptr<Compressor> g_CompSpdp = std::make_unique<SpdpCompressor>();
+static std::unique_ptr<Compressor> g_CompSpdpC256kT1 = std::make_unique<SpdpCompressor>(256 * 1024, 1);
+static std::unique_ptr<Compressor> g_CompSpdpC256k = std::make_unique<SpdpCompressor>(256 * 1024, 0);
 #if BUILD_WITH_NDZIP
 static std::unique_ptr<Compressor> g_CompNdzip = std::make_unique<NdzipCompressor>();
+static std::unique_ptr<Compressor> g_CompNdzipMT = std::make_unique<NdzipCompressor>(0, 0);
+static std::unique_ptr<Compressor> g_CompNdzipB64T2 = std::make_unique<NdzipCompressor>(64, 2);
+static std::unique_ptr<Compressor> g_CompNdzipB64 = std::make_unique<NdzipCompressor>(64, 0);
 #endif
 static std::unique_ptr<Compressor> g_CompStreamVByte = std::make_unique<StreamVByteCompressor>(kCompressionCount, false, false);
 static std::unique_ptr<Compressor> g_CompStreamVByteZstdFilter = std::make_unique<StreamVByteCompressor>(kCompressionZstd, true, true);
+static std::unique_ptr<Compressor> g_CompPFor = std::make_unique<PForCompressor>(kCompressionCount);
+static std::unique_ptr<Compressor> g_CompPForZstd = std::make_unique<PForCompressor>(kCompressionZstd);
+static std::unique_ptr<Compressor> g_CompPForLZ4 = std::make_unique<PForCompressor>(kCompressionLZ4);
+static std::unique_ptr<AdaptiveCompressor> g_CompAdaptive = std::make_unique<AdaptiveCompressor>(std::vector<AdaptiveCompressor::Candidate>{ {kCompressionLZ4, 0, 1300}, {kCompressionZstd, 1, 680}, {kCompressionZstd, 9, 620} });
 
 static std::unique_ptr<Compressor> g_CompMeshOptZstd = std::make_unique<MeshOptCompressor>(kCompressionZstd);
+static std::unique_ptr<Compressor> g_CompMeshOptExp15 = std::make_unique<MeshOptFilterCompressor>(kCompressionCount, kMeshOptFilterExp, 15);
+static std::unique_ptr<Compressor> g_CompMeshOptExp15Zstd = std::make_unique<MeshOptFilterCompressor>(kCompressionZstd, kMeshOptFilterExp, 15);
+static std::unique_ptr<Compressor> g_CompMeshOptExp10Zstd = std::make_unique<MeshOptFilterCompressor>(kCompressionZstd, kMeshOptFilterExp, 10);
+static std::unique_ptr<Compressor> g_CompMeshOptQuat12Zstd = std::make_unique<MeshOptFilterCompressor>(kCompressionZstd, kMeshOptFilterQuat, 12);
+static std::unique_ptr<Compressor> g_CompMeshOptOct12Zstd = std::make_unique<MeshOptFilterCompressor>(kCompressionZstd, kMeshOptFilterOct, 12);
+
+static std::unique_ptr<Compressor> g_CompLZ4Stream64k = std::make_unique<LZ4StreamCompressor>(64 * 1024, 0);
+static std::unique_ptr<Compressor> g_CompLZ4Stream64kR16 = std::make_unique<LZ4StreamCompressor>(64 * 1024, 16);
+static std::unique_ptr<Compressor> g_CompLZ4Stream64kR1 = std::make_unique<LZ4StreamCompressor>(64 * 1024, 1);
 
 
 struct TestFile
@@ -126,12 +205,21 @@ struct CompressorConfig
 	Compressor* cmp;
 	FilterDesc* filter;
 	BlockSize blockSizeEnum = kBSizeNone;
+	bool channelDict = false; // constant / low cardinality channel pre-pass before filter
+	const PrefilterDesc* prefilter = nullptr; // lossy rounding before everything else
+	bool morton = false; // Z-order reorder of 2D data, before channel pre-pass and filter
 
 	std::string GetName() const
 	{
 		char buf[100];
 		cmp->PrintName(sizeof(buf), buf);
 		std::string res = buf;
+		if (prefilter != nullptr)
+			res += prefilter->name;
+		if (morton)
+			res += "-zo";
+		if (channelDict)
+			res += "-cd";
 		if (filter != nullptr)
 			res += filter->name;
 		res += kBlockSizeName[blockSizeEnum];
@@ -139,7 +227,7 @@ struct CompressorConfig
 	}
 	const char* GetShapeString() const
 	{
-		if (cmp == g_CompLZSSE8.get())
+		if (cmp == g_CompLZSSE8.get() || cmp == g_CompLZSSE8Seg.get() || cmp == g_CompLZSSE8SegT1.get())
 		{
 			if (filter == &g_FilterSplit8DeltaOpt)
 				return "'triangle', pointSize: 10, lineWidth: 2";
@@ -160,6 +248,13 @@ struct CompressorConfig
 			else
 				return "{type:'square', rotation: 45}, pointSize: 8, lineDashStyle: [4, 2]";
 		}
+		if (cmp == g_CompLizard3x.get() || cmp == g_CompLizard4x.get() || cmp == g_CompLizard1xStride.get() || cmp == g_CompLizard2xStride.get())
+		{
+			if (filter == &g_FilterSplit8DeltaOpt)
+				return "'star', pointSize: 10, lineWidth: 2";
+			else
+				return "'star', pointSize: 8, lineDashStyle: [4, 2]";
+		}
 		if (cmp == g_CompBlosc.get() || cmp == g_CompBloscLZ4.get() || cmp == g_CompBloscZstd.get())
 			return "'circle', lineDashStyle: [4, 2]";
 		if (cmp == g_CompBlosc_Shuf.get() || cmp == g_CompBloscLZ4_Shuf.get() || cmp == g_CompBloscZstd_Shuf.get())
@@ -172,10 +267,16 @@ struct CompressorConfig
 		//	return "'circle', lineWidth: 3";
 		if (filter == &g_FilterSplit8DeltaOpt) return "'circle', pointSize: 4";
 		if (filter == &g_FilterSplit8Delta) return "'circle'";
+		if (filter == &g_FilterFieldSplit) return "'square', pointSize: 4";
+		if (filter == &g_FilterCrossChannel || filter == &g_FilterCrossChannelRef0) return "'triangle', pointSize: 4";
 		if (filter == &g_FilterSplit8AndDeltaDiff) return "{type:'square', rotation: 45}, lineDashStyle: [4, 4]";
 		if (filter == nullptr) return "'circle', lineDashStyle: [4, 2], pointSize: 4";
 		return "'circle'";
 	}
+	bool IsLossless() const { return prefilter == nullptr && cmp->IsLossless(); }
+	// rounding prefilters bound relative error only
+	double GetErrorBound(int level) const { return prefilter != nullptr ? -1.0 : cmp->GetErrorBound(level); }
+
 	uint32_t GetColor() const
 	{
 		// https://www.w3schools.com/colors/colors_picker.asp
@@ -204,9 +305,67 @@ struct CompressorConfig
 			if (blockSizeEnum == kBSize64k) return 0x4d4500;
 			return faded ? 0xd9d18c : 0xb19f00; // yellow
 		}
+		if (cmp == g_CompLZ4Stream64k.get()) return 0xe6cf00; // bright yellow
+		if (cmp == g_CompLZ4Stream64kR16.get()) return 0xffe94d; // light yellow
+		if (cmp == g_CompLZ4Stream64kR1.get()) return 0xfff59d; // pale yellow
+		if (cmp == g_CompZstdBypass.get()) return 0x2e7d32; // dark green
+		if (cmp == g_CompLZ4Bypass.get()) return 0xf9a825; // dark yellow
 		if (cmp == g_CompLZSSE8.get()) return 0x0099cc; // dark cyan
+		if (cmp == g_CompLZSSE8Seg.get()) return 0x006080; // darker cyan
+		if (cmp == g_CompLZSSE8SegT1.get()) return 0x66c2e0; // light cyan
+		if (cmp == g_CompGorilla.get()) return 0x607d8b; // blue gray
+		if (cmp == g_CompChimp128.get()) return 0x3f51b5; // indigo
+		if (cmp == g_CompAlp.get()) return 0x8bc34a; // light green
+		if (cmp == g_CompFpc.get()) return 0x795548; // brown
+		if (cmp == g_CompFpcT1.get()) return 0xa1887f; // light brown
 		if (cmp == g_CompLizard1x.get()) return 0xb81466; // rose
 		if (cmp == g_CompLizard2x.get()) return 0xcc6600; // orange
+		if (cmp == g_CompLizard3x.get()) return 0x7b1fa2; // purple
+		if (cmp == g_CompLizard4x.get()) return 0x00bfa7; // cyan
+		if (cmp == g_CompLizard1xStride.get()) return 0xd4a017; // dark yellow
+		if (cmp == g_CompLizard2xStride.get()) return 0x994400; // dark orange
+		if (cmp == g_CompRans.get()) return 0xe91e63; // pink
+		if (cmp == g_CompHuff0.get()) return 0x9c27b0; // magenta
+		if (cmp == g_CompZfpAcc.get()) return 0x2196f3; // blue
+		if (cmp == g_CompZfpPrec.get()) return 0x009688; // teal
+		if (cmp == g_CompZfpRate.get()) return 0xff9800; // amber
+		if (cmp == g_CompZfpOmp.get()) return 0xff5722; // deep orange
+		if (cmp == g_CompZfpPlanes.get()) return 0x283593; // dark indigo
+		if (cmp == g_CompZfpPlanesT1.get()) return 0x9fa8da; // light indigo
+		if (cmp == g_CompZfpPlanesT2.get()) return 0x5c6bc0; // indigo
+		if (cmp == g_CompZfpChDim.get()) return 0xce93d8; // light purple
+		if (cmp == g_CompZfpAccPlanes.get()) return 0x1565c0; // dark blue
+		if (cmp == g_CompZfpAccChDim.get()) return 0x90caf9; // light blue
+		if (cmp == g_CompSzZstd.get()) return 0x4caf50; // green
+		if (cmp == g_CompSzZstdT1.get()) return 0xa5d6a7; // light green
+		if (cmp == g_CompSzHuff0.get()) return 0x827717; // olive
+		if (cmp == g_CompCm.get()) return 0x311b92; // dark indigo
+		if (cmp == g_CompCmT1.get()) return 0x9575cd; // light indigo
+		if (cmp == g_CompHalfZstd.get()) return 0x00bcd4; // cyan
+		if (cmp == g_CompHalfLZ4.get()) return 0xcddc39; // lime
+		if (cmp == g_CompBf16Zstd.get()) return 0x673ab7; // deep purple
+		if (cmp == g_CompHalfVelZstd.get()) return 0x006064; // dark cyan
+		if (cmp == g_CompFpzipB64T1.get()) return 0xffcc80; // light orange
+		if (cmp == g_CompFpzipB64T2.get()) return 0xffa726; // orange
+		if (cmp == g_CompFpzipB64T4.get()) return 0xf57c00; // orange
+		if (cmp == g_CompFpzipB64.get()) return 0xe65100; // dark orange
+#if BUILD_WITH_NDZIP
+		if (cmp == g_CompNdzipMT.get()) return 0xcfd8dc; // light blue grey
+		if (cmp == g_CompNdzipB64T2.get()) return 0x78909c; // blue grey
+		if (cmp == g_CompNdzipB64.get()) return 0x37474f; // dark blue grey
+#endif
+		if (cmp == g_CompSpdpC256kT1.get()) return 0xb39ddb; // light deep purple
+		if (cmp == g_CompSpdpC256k.get()) return 0x512da8; // deep purple
+		if (cmp == g_CompPFor.get()) return 0x80deea; // light cyan
+		if (cmp == g_CompPForZstd.get()) return 0x0097a7; // dark cyan
+		if (cmp == g_CompPForLZ4.get()) return 0x26c6da; // cyan
+		if (cmp == g_CompAdaptive.get()) return 0xbf360c; // deep orange
+		if (cmp == g_CompMeshOptZstd.get()) return 0x6d4c41; // dark brown
+		if (cmp == g_CompMeshOptExp15.get()) return 0xbcaaa4; // light brown
+		if (cmp == g_CompMeshOptExp15Zstd.get()) return 0x8d6e63; // brown
+		if (cmp == g_CompMeshOptExp10Zstd.get()) return 0x4e342e; // dark brown
+		if (cmp == g_CompMeshOptQuat12Zstd.get()) return 0xad1457; // dark pink
+		if (cmp == g_CompMeshOptOct12Zstd.get()) return 0xf06292; // light pink
 		//if (cmp == g_CompZlib.get()) return faded ? 0x8cd9cf : 0x00bfa7; // cyan
 		//if (cmp == g_CompLibDeflate.get()) return 0x00786a; // cyan
 		//if (cmp == g_CompBrotli) return faded ? 0xd19a94 : 0xde5546; // orange
@@ -218,30 +377,67 @@ struct CompressorConfig
 
 	}
 
-	uint8_t* CompressWhole(const TestFile& tf, int level, size_t& outCompressedSize)
+	uint8_t* CompressWhole(const float* data, int width, int height, int channels, int level, size_t& outCompressedSize)
 	{
-		const float* srcData = tf.fileData.data();
+		const float* srcData = data;
 		uint8_t* filterBuffer = nullptr;
 		if (filter)
 		{
-			filterBuffer = new uint8_t[4 * tf.fileData.size()];
-			filter->filterFunc((const uint8_t*)srcData, filterBuffer, tf.channels * sizeof(float), tf.width * tf.height);
+			filterBuffer = new uint8_t[size_t(width) * height * channels * sizeof(float)];
+			filter->filterFunc((const uint8_t*)srcData, filterBuffer, channels * sizeof(float), width * height);
 			srcData = (const float*)filterBuffer;
 		}
 
 		outCompressedSize = 0;
-		uint8_t* compressed = cmp->Compress(level, srcData, tf.width, tf.height, tf.channels, outCompressedSize);
+		uint8_t* compressed = cmp->Compress(level, srcData, width, height, channels, outCompressedSize);
 		delete[] filterBuffer;
 		return compressed;
 	}
 
 	uint8_t* Compress(const TestFile& tf, int level, size_t& outCompressedSize)
+	{
+		const float* data = tf.fileData.data();
+		std::vector<float> rounded;
+		if (prefilter)
+		{
+			rounded.resize(tf.fileData.size());
+			std::vector<int> params(tf.channels, prefilter->param);
+			round_floats(data, rounded.data(), tf.channels, size_t(tf.width) * tf.height, prefilter->mode, params.data());
+			data = rounded.data();
+		}
+		std::vector<float> reordered;
+		if (morton)
+		{
+			reordered.resize(tf.fileData.size());
+			morton_reorder(data, reordered.data(), tf.width, tf.height, tf.channels);
+			data = reordered.data();
+		}
+		if (!channelDict)
+			return CompressData(data, tf.width, tf.height, tf.channels, level, outCompressedSize);
+
+		// output: pre-pass header, then remaining channels through filter + compressor
+		std::vector<uint8_t> header;
+		std::vector<float> rest;
+		int restChannels = 0;
+		chdict_encode(data, size_t(tf.width) * tf.height, tf.channels, header, rest, restChannels);
+		size_t restSize = 0;
+		uint8_t* restCmp = restChannels > 0 ? CompressData(rest.data(), tf.width, tf.height, restChannels, level, restSize) : nullptr;
+		outCompressedSize = header.size() + restSize;
+		uint8_t* compressed = new uint8_t[outCompressedSize];
+		memcpy(compressed, header.data(), header.size());
+		if (restSize)
+			memcpy(compressed + header.size(), restCmp, restSize);
+		delete[] restCmp;
+		return compressed;
+	}
+
+	uint8_t* CompressData(const float* data, int width, int height, int channels, int level, size_t& outCompressedSize)
 	{
 		if (blockSizeEnum == kBSizeNone)
-			return CompressWhole(tf, level, outCompressedSize);
+			return CompressWhole(data, width, height, channels, level, outCompressedSize);
 
-		const int stride = tf.channels * sizeof(float);
-		const int rowStride = tf.width * stride;
+		const int stride = channels * sizeof(float);
+		const int rowStride = width * stride;
 
 		size_t blockSize = kBlockSizeToActualSize[blockSizeEnum];
 		// make sure multiple of data elem size
@@ -254,8 +450,8 @@ struct CompressorConfig
 		if (filter)
 			filterBuffer = new uint8_t[blockSize];
 
-		const size_t dataSize = 4 * tf.fileData.size();
-		const uint8_t* srcData = (const uint8_t*)tf.fileData.data();
+		const size_t dataSize = size_t(width) * height * stride;
+		const uint8_t* srcData = (const uint8_t*)data;
 		uint8_t* compressed = new uint8_t[dataSize + 4];
 		size_t srcOffset = 0;
 		size_t cmpOffset = 0;
@@ -267,8 +463,8 @@ struct CompressorConfig
 				filter->filterFunc(srcData + srcOffset, filterBuffer, stride, thisBlockSize / stride);
 			}
 			size_t thisCmpSize = 0;
-			int blockWidth = tf.width;
-			int blockHeight = tf.height;
+			int blockWidth = width;
+			int blockHeight = height;
 			if (thisBlockSize > rowStride)
 			{
 				blockHeight = int(thisBlockSize / rowStride);
@@ -282,7 +478,7 @@ struct CompressorConfig
 				(const float*)(filter ? filterBuffer : srcData + srcOffset),
 				blockWidth,
 				blockHeight,
-				tf.channels,
+				channels,
 				thisCmpSize);
 			if (cmpOffset + thisCmpSize > dataSize)
 			{
@@ -307,25 +503,55 @@ struct CompressorConfig
 		return compressed;
 	}
 
-	void DecompressWhole(const TestFile& tf, const uint8_t* compressed, size_t compressedSize, float* dst)
+	void DecompressWhole(const uint8_t* compressed, size_t compressedSize, float* dst, int width, int height, int channels)
 	{
 		uint8_t* filterBuffer = nullptr;
 		if (filter)
-			filterBuffer = new uint8_t[4 * tf.fileData.size()];
-		cmp->Decompress(compressed, compressedSize, filter == nullptr ? dst : (float*)filterBuffer, tf.width, tf.height, tf.channels);
+			filterBuffer = new uint8_t[size_t(width) * height * channels * sizeof(float)];
+		cmp->Decompress(compressed, compressedSize, filter == nullptr ? dst : (float*)filterBuffer, width, height, channels);
 
 		if (filter)
 		{
-			filter->unfilterFunc(filterBuffer, (uint8_t*)dst, tf.channels * sizeof(float), tf.width * tf.height);
+			filter->unfilterFunc(filterBuffer, (uint8_t*)dst, channels * sizeof(float), width * height);
 			delete[] filterBuffer;
 		}
 	}
 
 	void Decompress(const TestFile& tf, const uint8_t* compressed, size_t compressedSize, float* dst)
+	{
+		if (morton)
+		{
+			std::vector<float> reordered(tf.fileData.size());
+			DecompressReordered(tf, compressed, compressedSize, reordered.data());
+			morton_unreorder(reordered.data(), dst, tf.width, tf.height, tf.channels);
+			return;
+		}
+		DecompressReordered(tf, compressed, compressedSize, dst);
+	}
+
+	void DecompressReordered(const TestFile& tf, const uint8_t* compressed, size_t compressedSize, float* dst)
+	{
+		if (!channelDict)
+		{
+			DecompressData(compressed, compressedSize, dst, tf.width, tf.height, tf.channels);
+			return;
+		}
+
+		const size_t headerSize = chdict_get_header_size(compressed);
+		const int restChannels = chdict_get_rest_channels(compressed);
+		const size_t dataElems = size_t(tf.width) * tf.height;
+		float* rest = new float[dataElems * restChannels];
+		if (restChannels > 0)
+			DecompressData(compressed + headerSize, compressedSize - headerSize, rest, tf.width, tf.height, restChannels);
+		chdict_decode(compressed, rest, dst, dataElems, tf.channels);
+		delete[] rest;
+	}
+
+	void DecompressData(const uint8_t* compressed, size_t compressedSize, float* dst, int width, int height, int channels)
 	{
 		if (blockSizeEnum == kBSizeNone)
 		{
-			DecompressWhole(tf, compressed, compressedSize, dst);
+			DecompressWhole(compressed, compressedSize, dst, width, height, channels);
 			return;
 		}
 
@@ -333,12 +559,12 @@ struct CompressorConfig
 		if (firstBlockCmpSize == 0)
 		{
 			// it was uncompressible data fallback
-			memcpy(dst, compressed + 4, tf.width * tf.height * tf.channels * sizeof(float));
+			memcpy(dst, compressed + 4, size_t(width) * height * channels * sizeof(float));
 			return;
 		}
 
-		const int stride = tf.channels * sizeof(float);
-		const int rowStride = tf.width * stride;
+		const int stride = channels * sizeof(float);
+		const int rowStride = width * stride;
 
 		size_t blockSize = kBlockSizeToActualSize[blockSizeEnum];
 		// make sure multiple of data elem size
@@ -352,15 +578,15 @@ struct CompressorConfig
 			filterBuffer = new uint8_t[blockSize];
 
 		uint8_t* dstData = (uint8_t*)dst;
-		const size_t dataSize = 4 * tf.fileData.size();
+		const size_t dataSize = size_t(width) * height * stride;
 		
 		size_t cmpOffset = 0;
 		size_t dstOffset = 0;
 		while (cmpOffset < compressedSize)
 		{
 			size_t thisBlockSize = std::min(blockSize, dataSize - dstOffset);
-			int blockWidth = tf.width;
-			int blockHeight = tf.height;
+			int blockWidth = width;
+			int blockHeight = height;
 			if (thisBlockSize > rowStride)
 			{
 				blockHeight = int(thisBlockSize / rowStride);
@@ -372,10 +598,10 @@ struct CompressorConfig
 			}
 
 			uint32_t thisCmpSize = *(const uint32_t*)(compressed + cmpOffset);
-			cmp->Decompress(compressed + cmpOffset + 4, thisCmpSize, (float*)(filter == nullptr ? dstData + dstOffset : filterBuffer), blockWidth, blockHeight, tf.channels);
+			cmp->Decompress(compressed + cmpOffset + 4, thisCmpSize, (float*)(filter == nullptr ? dstData + dstOffset : filterBuffer), blockWidth, blockHeight, channels);
 
 			if (filter)
-				filter->unfilterFunc(filterBuffer, dstData + dstOffset, tf.channels * sizeof(float), thisBlockSize / stride);
+				filter->unfilterFunc(filterBuffer, dstData + dstOffset, channels * sizeof(float), thisBlockSize / stride);
 
 			cmpOffset += 4 + thisCmpSize;
 			dstOffset += thisBlockSize;
@@ -393,6 +619,233 @@ static void TestCompressors(size_t testFileCount, TestFile* testFiles)
 	oodle_init();
 #	endif
   
+	// LZ4 linked blocks (streaming API) vs independent blocks
+	/*
+	g_Compressors.push_back({ g_CompLZ4Stream64k.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4Stream64kR16.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4Stream64kR1.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt, kBSize64k });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// Lizard with Huffman (3x, 4x) vs zstd
+	/*
+	g_Compressors.push_back({ g_CompLizard3x.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLizard4x.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLizard1x.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLizard2x.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLizard3x.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
+	g_Compressors.push_back({ g_CompLizard4x.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
+	*/
+
+	// Lizard with stride-aligned match candidates prioritized vs regular, on unfiltered data
+	/*
+	g_Compressors.push_back({ g_CompLizard1x.get(), nullptr });
+	g_Compressors.push_back({ g_CompLizard1xStride.get(), nullptr });
+	g_Compressors.push_back({ g_CompLizard2x.get(), nullptr });
+	g_Compressors.push_back({ g_CompLizard2xStride.get(), nullptr });
+	g_Compressors.push_back({ g_CompLizard2x.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// LZSSE8 on 1MB segments, multi-threaded vs single thread vs whole input
+	/*
+	g_Compressors.push_back({ g_CompLZSSE8Seg.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZSSE8SegT1.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZSSE8.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZSSE8Seg.get(), nullptr });
+	g_Compressors.push_back({ g_CompLZSSE8.get(), nullptr });
+	*/
+
+	// Gorilla / Chimp128 XOR float codecs, whole and in blocks
+	/*
+	g_Compressors.push_back({ g_CompGorilla.get(), nullptr });
+	g_Compressors.push_back({ g_CompChimp128.get(), nullptr });
+	g_Compressors.push_back({ g_CompGorilla.get(), nullptr, kBSize64k });
+	g_Compressors.push_back({ g_CompChimp128.get(), nullptr, kBSize64k });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// ALP decimal float codec vs zstd on attribute data (232630_float4, 953134_float3)
+	/*
+	g_Compressors.push_back({ g_CompAlp.get(), nullptr });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// FPC hash predictor codec (levels: table size), multi-threaded vs single thread, vs SPDP and zstd
+	/*
+	g_Compressors.push_back({ g_CompFpc.get(), nullptr });
+	g_Compressors.push_back({ g_CompFpcT1.get(), nullptr });
+	g_Compressors.push_back({ g_CompSpdp.get(), nullptr });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// Per byte plane rANS / Huff0 entropy coding vs zstd / LZ4 on split filtered data
+	/*
+	g_Compressors.push_back({ g_CompRans.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompHuff0.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompRans.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// Constant / low cardinality channel pre-pass (-cd) before split filter
+	/*
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, true });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, true });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSize1M, true });
+	*/
+
+	// Lossy zfp: accuracy (levels: error tolerance 10^-N), precision (bit planes), rate (bits/value)
+	/*
+	g_Compressors.push_back({ g_CompZfpAcc.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpPrec.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpRate.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfp.get(), nullptr });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// Lossy mantissa rounding prefilters (bit grooming / bit rounding / digit rounding) before split filter + zstd
+	/*
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, false, &g_PrefilterGroom12 });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, false, &g_PrefilterRound8 });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, false, &g_PrefilterRound12 });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, false, &g_PrefilterRound16 });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, false, &g_PrefilterDigits3 });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, false, &g_PrefilterDigits5 });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, false, &g_PrefilterRound12 });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// SZ style prediction + quantization (levels: error bound 10^-N) vs zfp accuracy mode
+	/*
+	g_Compressors.push_back({ g_CompSzZstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompSzZstdT1.get(), nullptr });
+	g_Compressors.push_back({ g_CompSzHuff0.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpAcc.get(), nullptr });
+	*/
+
+	// fp16 / bf16 packing + split/delta + zstd / LZ4, all channels or only some
+	/*
+	g_Compressors.push_back({ g_CompHalfZstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompHalfLZ4.get(), nullptr });
+	g_Compressors.push_back({ g_CompBf16Zstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompHalfVelZstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// zfp threading: OpenMP compression, channel planes as parallel streams (scaling is
+	// capped by channel count), and channels as an extra dimension
+	/*
+	g_Compressors.push_back({ g_CompZfp.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpOmp.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpPlanesT1.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpPlanesT2.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpPlanes.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpChDim.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpAcc.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpAccPlanes.get(), nullptr });
+	g_Compressors.push_back({ g_CompZfpAccChDim.get(), nullptr });
+	*/
+
+	// fpzip / ndzip: whole image vs. 64 row bands on 1/2/4/all threads
+	/*
+	g_Compressors.push_back({ g_CompFpzip.get(), nullptr });
+	g_Compressors.push_back({ g_CompFpzipB64T1.get(), nullptr });
+	g_Compressors.push_back({ g_CompFpzipB64T2.get(), nullptr });
+	g_Compressors.push_back({ g_CompFpzipB64T4.get(), nullptr });
+	g_Compressors.push_back({ g_CompFpzipB64.get(), nullptr });
+#	if BUILD_WITH_NDZIP
+	g_Compressors.push_back({ g_CompNdzip.get(), nullptr });
+	g_Compressors.push_back({ g_CompNdzipMT.get(), nullptr });
+	g_Compressors.push_back({ g_CompNdzipB64T2.get(), nullptr });
+	g_Compressors.push_back({ g_CompNdzipB64.get(), nullptr });
+#	endif
+	*/
+
+	// spdp: original vs. 256k chunks with SIMD delta stages (1 thread / all), vs. LZ with 1M blocks
+	/*
+	g_Compressors.push_back({ g_CompSpdp.get(), nullptr });
+	g_Compressors.push_back({ g_CompSpdpC256kT1.get(), nullptr });
+	g_Compressors.push_back({ g_CompSpdpC256k.get(), nullptr });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
+	*/
+
+	// FOR + SIMD bit packing + patched exceptions, raw and with zstd / LZ4, vs stream vbyte
+	/*
+	g_Compressors.push_back({ g_CompPFor.get(), nullptr });
+	g_Compressors.push_back({ g_CompPForZstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompPForLZ4.get(), nullptr });
+	g_Compressors.push_back({ g_CompStreamVByte.get(), nullptr });
+	g_Compressors.push_back({ g_CompStreamVByteZstdFilter.get(), nullptr });
+	*/
+
+	// float field split (sign+exponent, high 7 / low 16 mantissa bits) vs byte split + delta
+	/*
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterFieldSplit });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterFieldSplit });
+	*/
+
+	// zstd / LZ4 on split + delta planes, vs storing planes that look incompressible raw
+	/*
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompZstdBypass.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4Bypass.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// Z-order (Morton) reorder of 2D data before split + delta filter, vs row-major
+	/*
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, false, nullptr, true });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt, kBSizeNone, false, nullptr, true });
+	*/
+
+	// per block pick of LZ4 / zstd1 / zstd9, vs each of them on all blocks
+	/*
+	g_Compressors.push_back({ g_CompAdaptive.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
+	*/
+
+	// context mixing archival codec (levels: model size), multi-threaded vs single thread, vs SPDP and zstd
+	/*
+	g_Compressors.push_back({ g_CompCm.get(), nullptr });
+	g_Compressors.push_back({ g_CompCmT1.get(), nullptr });
+	g_Compressors.push_back({ g_CompSpdp.get(), nullptr });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	*/
+
+	// cross channel decorrelation (from previous / first channel) before split + delta, vs split + delta
+	/*
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterCrossChannel });
+	g_Compressors.push_back({ g_CompZstd.get(), &g_FilterCrossChannelRef0 });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterSplit8DeltaOpt });
+	g_Compressors.push_back({ g_CompLZ4.get(), &g_FilterCrossChannel });
+	*/
+
+	// meshopt attribute filters (lossy) vs plain meshopt; quat / oct fall back to exp
+	// filter on data that is not unit quaternions / vectors
+	/*
+	g_Compressors.push_back({ g_CompMeshOptZstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompMeshOptExp15.get(), nullptr });
+	g_Compressors.push_back({ g_CompMeshOptExp15Zstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompMeshOptExp10Zstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompMeshOptQuat12Zstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompMeshOptOct12Zstd.get(), nullptr });
+	g_Compressors.push_back({ g_CompHalfZstd.get(), nullptr });
+	*/
+
 	// Part 9 LZSSE + Lizard
 	g_Compressors.push_back({ g_CompLZSSE8.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
 	g_Compressors.push_back({ g_CompLizard1x.get(), &g_FilterSplit8DeltaOpt, kBSize1M });
@@ -573,6 +1026,10 @@ static void TestCompressors(size_t testFileCount, TestFile* testFiles)
 		size_t size = 0;
 		double cmpTime = 0;
 		double decTime = 0;
+		double maxErr = 0; // lossy compressors only
+		double errSqSum = 0;
+		double rmsErr = 0;
+		std::vector<double> chanRelErr; // max relative error per channel index
 	};
 	typedef std::vector<Result> LevelResults;
 	std::vector<LevelResults> results;
@@ -599,12 +1056,18 @@ static void TestCompressors(size_t testFileCount, TestFile* testFiles)
 			{
 				printf(".");
 				size_t cachedSize;
-				double cachedCmpTime, cachedDecTime;
-				if (ResCacheGet(cmpName.c_str(), res.level, &cachedSize, &cachedCmpTime, &cachedDecTime))
+				double cachedCmpTime, cachedDecTime, cachedMaxErr, cachedRmsErr;
+				std::vector<double> cachedChanRelErr;
+				if (ResCacheGet(cmpName.c_str(), res.level, &cachedSize, &cachedCmpTime, &cachedDecTime, &cachedMaxErr, &cachedRmsErr, &cachedChanRelErr))
 				{
+					res.chanRelErr.resize(std::max(res.chanRelErr.size(), cachedChanRelErr.size()));
+					for (size_t ch = 0; ch < cachedChanRelErr.size(); ++ch)
+						res.chanRelErr[ch] = std::max(res.chanRelErr[ch], cachedChanRelErr[ch]);
 					res.size += cachedSize;
 					res.cmpTime += cachedCmpTime;
 					res.decTime += cachedDecTime;
+					res.maxErr = std::max(res.maxErr, cachedMaxErr);
+					res.errSqSum += cachedRmsErr * cachedRmsErr * totalFloats;
 					res.cached = true;
 					continue;
 				}
@@ -633,8 +1096,37 @@ static void TestCompressors(size_t testFileCount, TestFile* testFiles)
 					res.cmpTime += tComp;
 					res.decTime += tDecomp;
 
-					// check validity
-					if (memcmp(tf.fileData.data(), decompressed.data(), 4 * tf.fileData.size()) != 0)
+					// check validity: lossy compressors against their error bound
+					if (!config.IsLossless())
+					{
+						double fileMaxErr = 0;
+						res.chanRelErr.resize(std::max(res.chanRelErr.size(), size_t(tf.channels)));
+						for (size_t i = 0; i < tf.fileData.size(); ++i)
+						{
+							float va = tf.fileData[i];
+							float vb = decompressed[i];
+							double err = 0.0; // equal values (incl. same inf) or both NaN: no error
+							if (va != vb && !(va != va && vb != vb))
+							{
+								err = fabs(double(va) - double(vb));
+								if (err != err) // NaN on one side only
+									err = INFINITY;
+							}
+							fileMaxErr = std::max(fileMaxErr, err);
+							res.errSqSum += err * err;
+							double relErr = va != 0 ? err / fabs(va) : (err != 0 ? INFINITY : 0.0);
+							double& chanRelErr = res.chanRelErr[i % tf.channels];
+							chanRelErr = std::max(chanRelErr, relErr);
+						}
+						res.maxErr = std::max(res.maxErr, fileMaxErr);
+						double bound = config.GetErrorBound(res.level);
+						if (bound >= 0 && fileMaxErr > bound)
+						{
+							printf("  ERROR, %s level %i max error %g is above bound %g on %s\n", cmpName.c_str(), res.level, fileMaxErr, bound, tf.path);
+							exit(1);
+						}
+					}
+					else if (memcmp(tf.fileData.data(), decompressed.data(), 4 * tf.fileData.size()) != 0)
 					{
 						printf("  ERROR, %s level %i did not decompress back to input on %s\n", cmpName.c_str(), res.level, tf.path);
 						for (size_t i = 0; i < 4 * tf.fileData.size(); ++i)
@@ -659,6 +1151,9 @@ static void TestCompressors(size_t testFileCount, TestFile* testFiles)
 		printf("\n");
 	}
 
+	if (!g_CompAdaptive->m_PickedBlocks.empty())
+		g_CompAdaptive->PrintStats("adapt", kRuns);
+
 	// normalize results, cache the ones we ran, produce compressor versions
 	int counterRan = 0, counterCached = 0;
 	std::set<std::string> cmpVersions;
@@ -675,11 +1170,12 @@ static void TestCompressors(size_t testFileCount, TestFile* testFiles)
 			res.size /= kRuns;
 			res.cmpTime /= kRuns;
 			res.decTime /= kRuns;
+			res.rmsErr = sqrt(res.errSqSum / (double(totalFloats) * kRuns));
 			if (!res.cached)
 			{
 				if (kWriteResultsCache)
 				{
-					ResCacheSet(cmpName.c_str(), res.level, res.size, res.cmpTime, res.decTime);
+					ResCacheSet(cmpName.c_str(), res.level, res.size, res.cmpTime, res.decTime, res.maxErr, res.rmsErr, &res.chanRelErr);
 				}
 			}
 			else
@@ -695,6 +1191,21 @@ static void TestCompressors(size_t testFileCount, TestFile* testFiles)
 	double oneMB = 1024.0 * 1024.0;
 	double oneGB = oneMB * 1024.0;
 	double rawSize = (double)(totalFloats * 4);
+
+	// print lossy compressor errors to screen
+	for (size_t ic = 0; ic < g_Compressors.size(); ++ic)
+	{
+		if (g_Compressors[ic].IsLossless())
+			continue;
+		cmpName = g_Compressors[ic].GetName();
+		for (const Result& res : results[ic])
+		{
+			printf("  %s %i: %.3fx max err %g rms err %g, max rel err per channel:", cmpName.c_str(), res.level, rawSize / res.size, res.maxErr, res.rmsErr);
+			for (double e : res.chanRelErr)
+				printf(" %g", e);
+			printf("\n");
+		}
+	}
 	// print results to screen
 	/*
 	printf("Compressor             SizeMB CTimeS  DTimeS Ratio CGB/s DGB/s\n");
@@ -759,7 +1270,14 @@ static void TestCompressors(size_t testFileCount, TestFile* testFiles)
 				fprintf(fout, " %i", res.level);
 			//if (strcmp(cmpName, "zstd-tst") == 0 && res.level == 1) // TEST TEST TEST
 			//	printf("%s_%i ratio: %.3f\n", cmpName, res.level, ratio);
-			fprintf(fout, "\\n%.3fx at %.3f GB/s\\n%.1FMB %.3fs','' ", ratio, cspeed / oneGB, csize / oneMB, ctime);
+			fprintf(fout, "\\n%.3fx at %.3f GB/s\\n%.1FMB %.3fs", ratio, cspeed / oneGB, csize / oneMB, ctime);
+			if (!g_Compressors[ic].IsLossless())
+			{
+				fprintf(fout, "\\nmax err %g rms err %g\\nrel err", res.maxErr, res.rmsErr);
+				for (double e : res.chanRelErr)
+					fprintf(fout, " %g", e);
+			}
+			fprintf(fout, "','' ");
 			for (size_t j = ic + 1; j < g_Compressors.size(); ++j) fprintf(fout, ",null,null,null");
 			fprintf(fout, "]%s\n", (ic == g_Compressors.size() - 1) && (&res == &levelRes.back()) ? "" : ",");
 		}
@@ -783,7 +1301,14 @@ static void TestCompressors(size_t testFileCount, TestFile* testFiles)
 			fprintf(fout, ", %.3f,'%s", ratio, cmpName.c_str());
 			if (levelRes.size() > 1)
 				fprintf(fout, " %i", res.level);
-			fprintf(fout, "\\n%.3fx at %.3f GB/s\\n%.1FMB %.3fs','' ", ratio, dspeed / oneGB, csize / oneMB, dtime);
+			fprintf(fout, "\\n%.3fx at %.3f GB/s\\n%.1FMB %.3fs", ratio, dspeed / oneGB, csize / oneMB, dtime);
+			if (!g_Compressors[ic].IsLossless())
+			{
+				fprintf(fout, "\\nmax err %g rms err %g\\nrel err", res.maxErr, res.rmsErr);
+				for (double e : res.chanRelErr)
+					fprintf(fout, " %g", e);
+			}
+			fprintf(fout, "','' ");
 			for (size_t j = ic + 1; j < g_Compressors.size(); ++j) fprintf(fout, ",null,null,null");
 			fprintf(fout, "]%s\n", (ic == g_Compressors.size() - 1) && (&res == &levelRes.back()) ? "" : ",");
 		}
@@ -1212,6 +1737,103 @@ static void TestFiltersOnFiles(size_t testFileCount, TestFile* testFiles)
 	}
 }
 
+// Compression ratio vs. error of rounding prefilters, for each channel of each file separately:
+// channel data is rounded, split+delta filtered and compressed with zstd level 1.
+static void TestPrefilterCurves(size_t testFileCount, TestFile* testFiles)
+{
+	printf("Testing rounding prefilters per channel:\n");
+	struct Curve
+	{
+		RoundMode mode;
+		const char* name;
+		std::vector<int> params;
+	};
+	const Curve kCurves[] = {
+		{ kRoundBits, "bits", { 4, 6, 8, 10, 12, 14, 16, 18, 20, 22 } },
+		{ kRoundDigits, "digits", { 1, 2, 3, 4, 5, 6, 7 } },
+	};
+
+	FILE* fout = fopen("../../report_prefilter.html", "wb");
+	fprintf(fout, "<script type='text/javascript' src='https://www.gstatic.com/charts/loader.js'></script>\n");
+	fprintf(fout, "<center style='font-family: Arial;'>\n");
+	for (size_t tfi = 0; tfi < testFileCount; ++tfi)
+		fprintf(fout, "<div id='chart_%zi' style='width: 1000px; height: 480px;'></div>\n", tfi);
+	fprintf(fout, "<p>CPU: %s Compiler: %s</p>\n", SysInfoGetCpuName().c_str(), SysInfoGetCompilerName().c_str());
+	fprintf(fout, "</center>\n");
+	fprintf(fout, "<script type='text/javascript'>\n");
+	fprintf(fout, "google.charts.load('current', {'packages':['corechart']});\n");
+	fprintf(fout, "google.charts.setOnLoadCallback(drawChart);\n");
+	fprintf(fout, "function drawChart() {\n");
+
+	for (size_t tfi = 0; tfi < testFileCount; ++tfi)
+	{
+		const TestFile& tf = testFiles[tfi];
+		const size_t elems = size_t(tf.width) * tf.height;
+		std::vector<float> src(elems), rounded(elems), filtered(elems);
+		size_t cmpBound = compress_calc_bound(elems * 4, kCompressionZstd);
+		std::vector<uint8_t> cmpBuffer(cmpBound);
+		const int seriesCount = tf.channels * int(std::size(kCurves));
+
+		// x: max relative error, one y column per channel+curve
+		fprintf(fout, "var data%zi = new google.visualization.DataTable();\n", tfi);
+		fprintf(fout, "data%zi.addColumn('number', 'Max relative error');\n", tfi);
+		for (int ch = 0; ch < tf.channels; ++ch)
+			for (const Curve& curve : kCurves)
+				fprintf(fout, "data%zi.addColumn('number', 'ch%i %s'); data%zi.addColumn({type:'string', role:'tooltip'});\n", tfi, ch, curve.name, tfi);
+		fprintf(fout, "data%zi.addRows([\n", tfi);
+
+		printf("%s:\n", tf.path);
+		int series = 0;
+		for (int ch = 0; ch < tf.channels; ++ch)
+		{
+			for (size_t i = 0; i < elems; ++i)
+				src[i] = tf.fileData[i * tf.channels + ch];
+			Filter_H((const uint8_t*)src.data(), (uint8_t*)filtered.data(), 4, elems);
+			size_t losslessSize = compress_data(filtered.data(), elems * 4, cmpBuffer.data(), cmpBound, kCompressionZstd, 1, 4);
+			printf("  ch%i lossless %.3fx\n", ch, elems * 4.0 / losslessSize);
+			for (const Curve& curve : kCurves)
+			{
+				printf("  ch%i %-6s", ch, curve.name);
+				for (int param : curve.params)
+				{
+					round_floats(src.data(), rounded.data(), 1, elems, curve.mode, &param);
+					double maxRelErr = 0, errSqSum = 0;
+					for (size_t i = 0; i < elems; ++i)
+					{
+						double err = fabs(double(src[i]) - double(rounded[i]));
+						if (src[i] != 0)
+							maxRelErr = std::max(maxRelErr, err / fabs(src[i]));
+						errSqSum += err * err;
+					}
+					Filter_H((const uint8_t*)rounded.data(), (uint8_t*)filtered.data(), 4, elems);
+					size_t cmpSize = compress_data(filtered.data(), elems * 4, cmpBuffer.data(), cmpBound, kCompressionZstd, 1, 4);
+					double ratio = elems * 4.0 / cmpSize;
+					double rmsErr = sqrt(errSqSum / elems);
+					printf(" %i:%.2fx", param, ratio);
+
+					fprintf(fout, "  [%g", std::max(maxRelErr, 1.0e-9));
+					for (int j = 0; j < series; ++j) fprintf(fout, ",null,null");
+					fprintf(fout, ", %.3f,'ch%i %s %i\\n%.3fx\\nmax rel err %g\\nrms err %g'", ratio, ch, curve.name, param, ratio, maxRelErr, rmsErr);
+					for (int j = series + 1; j < seriesCount; ++j) fprintf(fout, ",null,null");
+					fprintf(fout, "],\n");
+				}
+				printf("\n");
+				++series;
+			}
+		}
+		fprintf(fout, "]);\n");
+		fprintf(fout, "new google.visualization.ScatterChart(document.getElementById('chart_%zi')).draw(data%zi, {\n", tfi, tfi);
+		fprintf(fout, "title: '%s: zstd1 ratio vs rounding error, per channel',\n", tf.path);
+		fprintf(fout, "pointSize: 6, lineWidth: 1, chartArea: {left:60, right:180, top:50, bottom:60},\n");
+		fprintf(fout, "hAxis: {title: 'max relative error', logScale: true, direction: -1},\n");
+		fprintf(fout, "vAxis: {title: 'ratio'},\n");
+		fprintf(fout, "});\n");
+	}
+	fprintf(fout, "}\n");
+	fprintf(fout, "</script>\n");
+	fclose(fout);
+}
+
 
 int main()
 {
@@ -1247,6 +1869,7 @@ int main()
 
 	//TestFiltersOnSyntheticData();
 	//TestFiltersOnFiles(std::size(testFiles), testFiles);
+	//TestPrefilterCurves(std::size(testFiles), testFiles);
 
 	TestCompressors(std::size(testFiles), testFiles);
 
@@ -1255,8 +1878,5 @@ int main()
 }
 
 // Lossy:
-// SZ https://github.com/szcompressor/SZ
 // DCTZ https://github.com/swson/DCTZ
-// digitroundingZ https://github.com/disheng222/digitroundingZ
-// BitGroomingZ https://github.com/disheng222/BitGroomingZ
 // Change a Bit to save Bytes: Compression for Floating Point Time-Series Data: https://arxiv.org/abs/2303.04478
@@ -0,0 +1,118 @@
+#include "morton.h"
+#include "simd.h"
+#include <string.h>
+#include <vector>
+
+#if defined(__BMI2__) || defined(__AVX2__)
+#include <immintrin.h>
+#define MORTON_PDEP 1
+#endif
+
+const int kMortonMaxTileBits = 8;
+
+// spread low 16 bits of x into even bits
+static inline uint32_t SpreadBits(uint32_t x)
+{
+#if MORTON_PDEP
+    return _pdep_u32(x, 0x55555555);
+#else
+    x &= 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+#endif
+}
+
+static int GetTileBits(int width, int height)
+{
+    int bits = 0;
+    while (bits < kMortonMaxTileBits && (2 << bits) <= width && (2 << bits) <= height)
+        ++bits;
+    return bits;
+}
+
+// copies one element of `stride` bytes from grid to linear order, or back for the inverse
+template<bool Inverse, int Stride> static inline void CopyElem(uint8_t* linear, uint8_t* grid, size_t stride)
+{
+    uint8_t* dst = Inverse ? grid : linear;
+    const uint8_t* src = Inverse ? linear : grid;
+    if constexpr (Stride == 16)
+        SimdStore(dst, SimdLoad(src));
+    else if constexpr (Stride != 0)
+        memcpy(dst, src, Stride);
+    else
+        memcpy(dst, src, stride);
+}
+
+// linear: Z-ordered data, grid: row-major data (source for forward, destination for inverse)
+template<bool Inverse, int Stride>
+static void MortonReorder(uint8_t* linear, uint8_t* grid, int width, int height, size_t stride)
+{
+    const int tileBits = GetTileBits(width, height);
+    const int tileSize = 1 << tileBits;
+    const int tilesX = width >> tileBits, tilesY = height >> tileBits;
+    const size_t rowStride = size_t(width) * stride;
+    if (tileBits == 0)
+    {
+        CopyElem<Inverse, 0>(linear, grid, size_t(height) * rowStride);
+        return;
+    }
+
+    // offset of each Z-order index within the tile, in bytes
+    std::vector<size_t> offsets(size_t(tileSize) * tileSize);
+    for (int y = 0; y < tileSize; ++y)
+    {
+        const uint32_t zy = SpreadBits(y) << 1;
+        for (int x = 0; x < tileSize; ++x)
+            offsets[zy | SpreadBits(x)] = y * rowStride + x * stride;
+    }
+
+    // whole tiles
+    for (int ty = 0; ty < tilesY; ++ty)
+    {
+        for (int tx = 0; tx < tilesX; ++tx)
+        {
+            uint8_t* tile = grid + size_t(ty) * tileSize * rowStride + size_t(tx) * tileSize * stride;
+            for (size_t i = 0; i < offsets.size(); ++i)
+            {
+                CopyElem<Inverse, Stride>(linear, tile + offsets[i], stride);
+                linear += stride;
+            }
+        }
+    }
+
+    // right edge columns of the tiled rows, then bottom rows
+    const size_t edgeX = size_t(tilesX) * tileSize * stride;
+    const size_t edgeSize = rowStride - edgeX;
+    for (int y = 0; y < tilesY * tileSize && edgeSize != 0; ++y)
+    {
+        CopyElem<Inverse, 0>(linear, grid + y * rowStride + edgeX, edgeSize);
+        linear += edgeSize;
+    }
+    const size_t bottom = size_t(tilesY) * tileSize * rowStride;
+    CopyElem<Inverse, 0>(linear, grid + bottom, size_t(height) * rowStride - bottom);
+}
+
+template<bool Inverse>
+static void MortonReorder(uint8_t* linear, uint8_t* grid, int width, int height, int channels)
+{
+    switch (channels)
+    {
+    case 1: MortonReorder<Inverse, 4>(linear, grid, width, height, 4); break;
+    case 2: MortonReorder<Inverse, 8>(linear, grid, width, height, 8); break;
+    case 4: MortonReorder<Inverse, 16>(linear, grid, width, height, 16); break;
+    default: MortonReorder<Inverse, 0>(linear, grid, width, height, channels * sizeof(float)); break;
+    }
+}
+
+void morton_reorder(const float* src, float* dst, int width, int height, int channels)
+{
+    MortonReorder<false>((uint8_t*)dst, (uint8_t*)src, width, height, channels);
+}
+
+void morton_unreorder(const float* src, float* dst, int width, int height, int channels)
+{
+    MortonReorder<true>((uint8_t*)src, (uint8_t*)dst, width, height, channels);
+}
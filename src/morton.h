@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Z-order (Morton order) reordering of 2D interleaved float data, so that vertically
+// neighboring values end up close in memory for LZ match finders and 1D deltas.
+// Image is cut into square tiles (2^k size, up to 256x256, not larger than the image),
+// tiles are in row-major order and elements within a tile are in Z-order. Columns and rows
+// at the right / bottom edge that do not make up a whole tile follow in row-major order.
+// Element order within a tile comes from a table of offsets made with BMI2 pdep when
+// available; the inverse uses the same table.
+void morton_reorder(const float* src, float* dst, int width, int height, int channels);
+void morton_unreorder(const float* src, float* dst, int width, int height, int channels);
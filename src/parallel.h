@@ -0,0 +1,48 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+inline int GetHardwareThreadCount()
+{
+	int count = (int)std::thread::hardware_concurrency();
+	return count > 0 ? count : 1;
+}
+
+// Calls func(index, threadIndex) for all index in [0, count), using up to threadCount
+// threads (0: all hardware threads). Indices are handed out dynamically so that uneven
+// work items balance out; threadIndex is in [0, threadCount) and can be used to pick
+// per-thread state. With one thread (or one item) everything runs on the calling thread.
+template<typename Func>
+void ParallelFor(int count, int threadCount, Func func)
+{
+	if (threadCount <= 0)
+		threadCount = GetHardwareThreadCount();
+	threadCount = std::min(threadCount, count);
+	if (threadCount <= 1)
+	{
+		for (int i = 0; i < count; ++i)
+			func(i, 0);
+		return;
+	}
+
+	std::atomic<int> next = 0;
+	auto worker = [&](int threadIndex)
+	{
+		while (true)
+		{
+			int i = next.fetch_add(1);
+			if (i >= count)
+				break;
+			func(i, threadIndex);
+		}
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (int t = 1; t < threadCount; ++t)
+		threads.emplace_back(worker, t);
+	worker(0);
+	for (auto& th : threads)
+		th.join();
+}
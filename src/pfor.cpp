@@ -0,0 +1,264 @@
+#include "pfor.h"
+#include "bitpack.h"
+#include "simd.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+struct PForHeader
+{
+    uint32_t blockCount;
+    uint32_t excCount;
+    uint32_t packedWords;
+    uint32_t excWidthCounts[32]; // exceptions with high part width 1..32
+    // followed by: block bases (u32 per block), block bit widths, block exception counts
+    // and block exception high widths (u8 per block each, padded to 4), exception positions
+    // (u8 each, padded to 4), exception high parts for each width (bit packed groups),
+    // packed block data
+};
+
+static size_t PadTo4(size_t size)
+{
+    return (size + 3) & ~size_t(3);
+}
+
+static size_t GetBlockCount(size_t dataElems, int channels)
+{
+    return (dataElems + kBitPackGroup - 1) / kBitPackGroup * channels;
+}
+
+static uint32_t ZigZag(uint32_t v)
+{
+    return (v << 1) ^ uint32_t(int32_t(v) >> 31);
+}
+
+size_t pfor_compress_bound(size_t dataElems, int channels)
+{
+    size_t blocks = GetBlockCount(dataElems, channels);
+    size_t excWords = 0;
+    for (int w = 1; w <= 32; ++w)
+        excWords += 4 * w; // worst case padding of each exception group
+    return sizeof(PForHeader) + blocks * 4 + PadTo4(blocks * 3) + PadTo4(blocks * kBitPackGroup) + (excWords + blocks * kBitPackGroup) * 4 + blocks * kBitPackGroup * 4;
+}
+
+size_t pfor_compress(const float* src, size_t dataElems, int channels, uint8_t* dst)
+{
+    const size_t blockCount = GetBlockCount(dataElems, channels);
+    std::vector<uint32_t> bases(blockCount);
+    std::vector<uint8_t> blockBits(blockCount), blockExcCounts(blockCount), blockExcWidths(blockCount);
+    std::vector<uint8_t> excPositions;
+    std::vector<uint32_t> excHigh[32];
+    std::vector<uint32_t> packed;
+    packed.reserve(dataElems * channels);
+
+    const uint32_t* srcInt = (const uint32_t*)src;
+    std::vector<uint32_t> prevs(channels, 0);
+    size_t blockIndex = 0;
+    for (size_t start = 0; start < dataElems; start += kBitPackGroup)
+    {
+        const int count = int(std::min<size_t>(kBitPackGroup, dataElems - start));
+        for (int ch = 0; ch < channels; ++ch, ++blockIndex)
+        {
+            uint32_t vals[kBitPackGroup];
+            uint32_t prev = prevs[ch];
+            for (int i = 0; i < count; ++i)
+            {
+                uint32_t v = srcInt[(start + i) * channels + ch];
+                vals[i] = ZigZag(v - prev);
+                prev = v;
+            }
+            prevs[ch] = prev;
+            // pad partial block with last value, so that it does not widen the frame
+            for (int i = count; i < kBitPackGroup; ++i)
+                vals[i] = vals[count - 1];
+
+            uint32_t base = vals[0];
+            for (int i = 1; i < kBitPackGroup; ++i)
+                base = std::min(base, vals[i]);
+            int widthCounts[33] = {};
+            int maxBits = 0;
+            for (int i = 0; i < kBitPackGroup; ++i)
+            {
+                vals[i] -= base;
+                int w = BitPackWidth(vals[i]);
+                widthCounts[w]++;
+                maxBits = std::max(maxBits, w);
+            }
+
+            // pick width with smallest cost: packed bits + exceptions (position byte + high bits)
+            int bits = maxBits;
+            size_t bestCost = size_t(maxBits) * kBitPackGroup;
+            int excCount = 0;
+            for (int b = maxBits - 1; b >= 0; --b)
+            {
+                excCount += widthCounts[b + 1];
+                size_t cost = size_t(b) * kBitPackGroup + size_t(excCount) * (8 + maxBits - b);
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bits = b;
+                }
+            }
+
+            bases[blockIndex] = base;
+            blockBits[blockIndex] = uint8_t(bits);
+            blockExcWidths[blockIndex] = uint8_t(maxBits - bits);
+            int blockExc = 0;
+            if (bits < maxBits)
+            {
+                std::vector<uint32_t>& high = excHigh[maxBits - bits - 1];
+                for (int i = 0; i < kBitPackGroup; ++i)
+                {
+                    if (vals[i] >> bits)
+                    {
+                        excPositions.push_back(uint8_t(i));
+                        high.push_back(vals[i] >> bits);
+                        ++blockExc;
+                    }
+                }
+            }
+            blockExcCounts[blockIndex] = uint8_t(blockExc);
+
+            size_t packedPos = packed.size();
+            packed.resize(packedPos + 4 * bits);
+            BitPack128(vals, packed.data() + packedPos, bits);
+        }
+    }
+
+    PForHeader* hdr = (PForHeader*)dst;
+    hdr->blockCount = uint32_t(blockCount);
+    hdr->excCount = uint32_t(excPositions.size());
+    hdr->packedWords = uint32_t(packed.size());
+    uint8_t* out = dst + sizeof(PForHeader);
+    memcpy(out, bases.data(), blockCount * 4);
+    out += blockCount * 4;
+    memcpy(out, blockBits.data(), blockCount);
+    memcpy(out + blockCount, blockExcCounts.data(), blockCount);
+    memcpy(out + blockCount * 2, blockExcWidths.data(), blockCount);
+    out += PadTo4(blockCount * 3);
+    memcpy(out, excPositions.data(), excPositions.size());
+    out += PadTo4(excPositions.size());
+    for (int w = 1; w <= 32; ++w)
+    {
+        std::vector<uint32_t>& high = excHigh[w - 1];
+        hdr->excWidthCounts[w - 1] = uint32_t(high.size());
+        if (high.empty())
+            continue;
+        size_t groups = (high.size() + kBitPackGroup - 1) / kBitPackGroup;
+        high.resize(groups * kBitPackGroup, 0);
+        for (size_t g = 0; g < groups; ++g)
+        {
+            BitPack128(high.data() + g * kBitPackGroup, (uint32_t*)out, w);
+            out += 16 * w;
+        }
+    }
+    memcpy(out, packed.data(), packed.size() * 4);
+    out += packed.size() * 4;
+    return out - dst;
+}
+
+void pfor_decompress(const uint8_t* src, size_t srcSize, float* dst, size_t dataElems, int channels)
+{
+    const PForHeader* hdr = (const PForHeader*)src;
+    const size_t blockCount = hdr->blockCount;
+    const uint8_t* ptr = src + sizeof(PForHeader);
+    const uint32_t* bases = (const uint32_t*)ptr;
+    ptr += blockCount * 4;
+    const uint8_t* blockBits = ptr;
+    const uint8_t* blockExcCounts = ptr + blockCount;
+    const uint8_t* blockExcWidths = ptr + blockCount * 2;
+    ptr += PadTo4(blockCount * 3);
+    const uint8_t* excPositions = ptr;
+    ptr += PadTo4(hdr->excCount);
+
+    // unpack exception high parts of all widths up front
+    std::vector<uint32_t> excHigh[32];
+    size_t excCursor[32] = {};
+    for (int w = 1; w <= 32; ++w)
+    {
+        size_t count = hdr->excWidthCounts[w - 1];
+        if (count == 0)
+            continue;
+        size_t groups = (count + kBitPackGroup - 1) / kBitPackGroup;
+        excHigh[w - 1].resize(groups * kBitPackGroup);
+        for (size_t g = 0; g < groups; ++g)
+        {
+            BitUnpack128((const uint32_t*)ptr, excHigh[w - 1].data() + g * kBitPackGroup, w, 0);
+            ptr += 16 * w;
+        }
+    }
+    const uint32_t* packed = (const uint32_t*)ptr;
+
+    static const uint8_t kLastLaneTable[16] = { 12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15 };
+    const Bytes16 kLastLane = SimdLoad(kLastLaneTable);
+    const Bytes16 kOne = SimdSet1U32(1);
+    uint32_t* dstInt = (uint32_t*)dst;
+    std::vector<uint32_t> prevs(channels, 0);
+    std::vector<uint32_t> chanVals(channels * kBitPackGroup);
+    size_t blockIndex = 0;
+    for (size_t start = 0; start < dataElems; start += kBitPackGroup)
+    {
+        for (int ch = 0; ch < channels; ++ch, ++blockIndex)
+        {
+            const int bits = blockBits[blockIndex];
+            uint32_t* vals = chanVals.data() + ch * kBitPackGroup;
+            BitUnpack128(packed, vals, bits, bases[blockIndex]);
+            packed += 4 * bits;
+
+            // patch exceptions
+            const int excCount = blockExcCounts[blockIndex];
+            if (excCount != 0)
+            {
+                const int w = blockExcWidths[blockIndex] - 1;
+                const uint32_t* high = excHigh[w].data() + excCursor[w];
+                for (int i = 0; i < excCount; ++i)
+                    vals[excPositions[i]] += high[i] << bits;
+                excPositions += excCount;
+                excCursor[w] += excCount;
+            }
+
+            // undo zigzag, and prefix sum to undo delta
+            Bytes16 prev = SimdSet1U32(prevs[ch]);
+            for (int i = 0; i < kBitPackGroup; i += 4)
+            {
+                Bytes16 z = SimdLoad(vals + i);
+                Bytes16 d = SimdXor(SimdShiftRightU32(z, 1), SimdSubU32(SimdZero(), SimdAnd(z, kOne)));
+                d = SimdAddU32(d, SimdConcat<12>(d, SimdZero()));
+                d = SimdAddU32(d, SimdConcat<8>(d, SimdZero()));
+                d = SimdAddU32(d, prev);
+                SimdStore(vals + i, d);
+                prev = SimdShuffle(d, kLastLane);
+            }
+            prevs[ch] = vals[kBitPackGroup - 1];
+        }
+
+        // interleave channels back
+        const int count = int(std::min<size_t>(kBitPackGroup, dataElems - start));
+        uint32_t* out = dstInt + start * channels;
+        if (channels == 1)
+        {
+            memcpy(out, chanVals.data(), count * 4);
+        }
+        else if (channels == 4 && count == kBitPackGroup)
+        {
+            const uint32_t* v = chanVals.data();
+            for (int i = 0; i < kBitPackGroup; i += 4, out += 16)
+            {
+                Bytes16 a = SimdLoad(v + i), b = SimdLoad(v + kBitPackGroup + i);
+                Bytes16 c = SimdLoad(v + kBitPackGroup * 2 + i), d = SimdLoad(v + kBitPackGroup * 3 + i);
+                Bytes16 ab0 = SimdInterleave4L(a, b), ab1 = SimdInterleave4R(a, b);
+                Bytes16 cd0 = SimdInterleave4L(c, d), cd1 = SimdInterleave4R(c, d);
+                SimdStore(out + 0, SimdInterleave8L(ab0, cd0));
+                SimdStore(out + 4, SimdInterleave8R(ab0, cd0));
+                SimdStore(out + 8, SimdInterleave8L(ab1, cd1));
+                SimdStore(out + 12, SimdInterleave8R(ab1, cd1));
+            }
+        }
+        else
+        {
+            for (int i = 0; i < count; ++i)
+                for (int ch = 0; ch < channels; ++ch)
+                    *out++ = chanVals[ch * kBitPackGroup + i];
+        }
+    }
+}
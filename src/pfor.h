@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// FastPFor style ("Decoding billions of integers per second through vectorization",
+// Lemire & Boytsov 2015) integer codec for float32 bit patterns: each channel of interleaved
+// input is delta coded as 32 bit integers and zigzag mapped, then in blocks of 128 values:
+// frame of reference (block minimum), SIMD bit packing at a width picked to minimize size,
+// and values that do not fit that width are patched exceptions (PFor): their positions and
+// high bits are stored separately, high bits grouped by width and bit packed too.
+size_t pfor_compress_bound(size_t dataElems, int channels);
+size_t pfor_compress(const float* src, size_t dataElems, int channels, uint8_t* dst);
+void pfor_decompress(const uint8_t* src, size_t srcSize, float* dst, size_t dataElems, int channels);
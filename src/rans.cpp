@@ -0,0 +1,428 @@
+#include "rans.h"
+#include "simd.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static const int kRansProbBits = 12;
+static const uint32_t kRansProbScale = 1 << kRansProbBits;
+static const uint32_t kRansL = 1 << 16; // lower bound of state range
+static const int kRansLanes = 16;
+static_assert(kRansLanes == 16, "SIMD decoder assumes 4 registers of 4 lanes");
+static const int kRansMaxPlanes = 64;
+static const int kRansPad = 8; // decoder reads up to 8 bytes past the stream
+
+enum RansPlaneMode : uint8_t
+{
+    kRansPlaneCoded = 0,
+    kRansPlaneConstant,
+    kRansPlaneRaw,
+};
+
+struct RansHeader
+{
+    uint32_t size;
+    uint32_t planes;
+};
+
+// decode table entry: symbol in bits 0..7, (slot - start) in bits 8..19, frequency in bits 20..31
+typedef uint32_t RansDecEntry;
+
+static void RansNormalizeFreqs(const uint32_t counts[256], size_t total, uint32_t freqs[256])
+{
+    uint32_t sum = 0;
+    int largest = 0;
+    for (int i = 0; i < 256; ++i)
+    {
+        freqs[i] = 0;
+        if (counts[i] == 0)
+            continue;
+        freqs[i] = std::max<uint32_t>(1, uint32_t(uint64_t(counts[i]) * kRansProbScale / total));
+        sum += freqs[i];
+        if (counts[i] > counts[largest])
+            largest = i;
+    }
+    // give rounding leftovers to the most frequent symbol; if rare symbols got bumped
+    // to 1 and we went over, take from the largest frequencies instead
+    if (sum <= kRansProbScale)
+    {
+        freqs[largest] += kRansProbScale - sum;
+        return;
+    }
+    while (sum > kRansProbScale)
+    {
+        int idx = int(std::max_element(freqs, freqs + 256) - freqs);
+        --freqs[idx];
+        --sum;
+    }
+}
+
+static size_t RansWriteFreqs(const uint32_t freqs[256], uint8_t* dst)
+{
+    // 256 bit presence mask, then (freq-1) of present symbols as 1 or 2 byte varints
+    uint8_t* out = dst;
+    memset(out, 0, 32);
+    for (int i = 0; i < 256; ++i)
+        if (freqs[i])
+            out[i >> 3] |= 1 << (i & 7);
+    out += 32;
+    for (int i = 0; i < 256; ++i)
+    {
+        if (!freqs[i])
+            continue;
+        uint32_t v = freqs[i] - 1;
+        if (v < 128)
+            *out++ = uint8_t(v);
+        else
+        {
+            *out++ = uint8_t(v | 128);
+            *out++ = uint8_t(v >> 7);
+        }
+    }
+    return out - dst;
+}
+
+static const uint8_t* RansReadFreqs(const uint8_t* src, uint32_t freqs[256])
+{
+    const uint8_t* mask = src;
+    src += 32;
+    for (int i = 0; i < 256; ++i)
+    {
+        freqs[i] = 0;
+        if (!(mask[i >> 3] & (1 << (i & 7))))
+            continue;
+        uint32_t v = *src++;
+        if (v & 128)
+            v = (v & 127) | (uint32_t(*src++) << 7);
+        freqs[i] = v + 1;
+    }
+    return src;
+}
+
+static inline void RansEncPut(uint32_t& x, uint16_t*& ptr, uint32_t freq, uint32_t start)
+{
+    if (x >= (freq << (32 - kRansProbBits)))
+    {
+        *--ptr = uint16_t(x);
+        x >>= 16;
+    }
+    x = ((x / freq) << kRansProbBits) + (x % freq) + start;
+}
+
+// encodes backwards into [buf, bufEnd); returns pointer to start of stream
+static uint8_t* RansEncodePlane(const uint8_t* src, size_t count, const uint32_t freqs[256], uint8_t* bufEnd)
+{
+    uint32_t starts[256];
+    uint32_t start = 0;
+    for (int i = 0; i < 256; ++i)
+    {
+        starts[i] = start;
+        start += freqs[i];
+    }
+
+    uint32_t state[kRansLanes];
+    for (int j = 0; j < kRansLanes; ++j)
+        state[j] = kRansL;
+    uint16_t* ptr = (uint16_t*)bufEnd;
+    // symbol i goes to lane i % kRansLanes; encode in reverse so that the decoder reads
+    // renormalization words front to back, lanes in increasing order
+    size_t full = count / kRansLanes;
+    size_t tail = count % kRansLanes;
+    for (size_t j = tail; j-- > 0; )
+    {
+        uint8_t s = src[full * kRansLanes + j];
+        RansEncPut(state[j], ptr, freqs[s], starts[s]);
+    }
+    for (size_t g = full; g-- > 0; )
+    {
+        const uint8_t* grp = src + g * kRansLanes;
+        for (int j = kRansLanes - 1; j >= 0; --j)
+            RansEncPut(state[j], ptr, freqs[grp[j]], starts[grp[j]]);
+    }
+    uint8_t* out = (uint8_t*)ptr;
+    for (int j = kRansLanes - 1; j >= 0; --j)
+    {
+        out -= 4;
+        memcpy(out, &state[j], 4);
+    }
+    return out;
+}
+
+static void RansBuildDecodeTable(const uint32_t freqs[256], RansDecEntry* table)
+{
+    uint32_t start = 0;
+    for (int s = 0; s < 256; ++s)
+    {
+        for (uint32_t i = 0; i < freqs[s]; ++i)
+            table[start + i] = RansDecEntry(s | (i << 8) | (freqs[s] << 20));
+        start += freqs[s];
+    }
+}
+
+static inline uint8_t RansDecGet(uint32_t& x, const RansDecEntry* table)
+{
+    RansDecEntry e = table[x & (kRansProbScale - 1)];
+    x = (e >> 20) * (x >> kRansProbBits) + ((e >> 8) & 0xFFF);
+    return uint8_t(e);
+}
+
+static inline void RansDecRenorm(uint32_t& x, const uint8_t*& ptr)
+{
+    if (x < kRansL)
+    {
+        uint16_t w;
+        memcpy(&w, ptr, 2);
+        ptr += 2;
+        x = (x << 16) | w;
+    }
+}
+
+#if CPU_ARCH_X64
+// for a 4 bit mask of lanes needing refill, shuffle that moves consecutive 16 bit
+// words into the low half of those lanes (in lane order), zeroing everything else;
+// and how many bytes that consumes
+struct RansRefillShuffles
+{
+    uint8_t shuf[16][16];
+    uint8_t bytes[16];
+    RansRefillShuffles()
+    {
+        for (int m = 0; m < 16; ++m)
+        {
+            int word = 0;
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                uint8_t* s = shuf[m] + lane * 4;
+                s[0] = s[1] = s[2] = s[3] = 0x80;
+                if (m & (1 << lane))
+                {
+                    s[0] = uint8_t(word * 2);
+                    s[1] = uint8_t(word * 2 + 1);
+                    ++word;
+                }
+            }
+            bytes[m] = uint8_t(word * 2);
+        }
+    }
+};
+static const RansRefillShuffles s_RansRefill;
+
+static inline __m128i RansRefillNeed(__m128i x, int& mask)
+{
+    __m128i need = _mm_cmpeq_epi32(_mm_srli_epi32(x, 16), _mm_setzero_si128());
+    mask = _mm_movemask_ps(_mm_castsi128_ps(need));
+    return need;
+}
+
+static inline __m128i RansRefill4(__m128i x, __m128i need, int mask, const uint8_t*& ptr)
+{
+    __m128i words = _mm_shuffle_epi8(_mm_loadl_epi64((const __m128i*)ptr), _mm_loadu_si128((const __m128i*)s_RansRefill.shuf[mask]));
+    ptr += s_RansRefill.bytes[mask];
+    return _mm_blendv_epi8(x, _mm_or_si128(_mm_slli_epi32(x, 16), words), need);
+}
+
+static inline __m128i RansDecode4(__m128i x, const RansDecEntry* table, __m128i& sym)
+{
+    __m128i slot = _mm_and_si128(x, _mm_set1_epi32(kRansProbScale - 1));
+    uint64_t s01 = _mm_cvtsi128_si64(slot);
+    uint64_t s23 = _mm_extract_epi64(slot, 1);
+    __m128i e = _mm_setr_epi32(table[uint32_t(s01)], table[s01 >> 32], table[uint32_t(s23)], table[s23 >> 32]);
+    __m128i freq = _mm_srli_epi32(e, 20);
+    __m128i bias = _mm_and_si128(_mm_srli_epi32(e, 8), _mm_set1_epi32(0xFFF));
+    sym = _mm_and_si128(e, _mm_set1_epi32(0xFF));
+    return _mm_add_epi32(_mm_mullo_epi32(freq, _mm_srli_epi32(x, kRansProbBits)), bias);
+}
+
+#if defined(__AVX2__)
+// decodes 8 lanes from two registers with a gather; xb gets the new state of the upper 4 lanes
+static inline __m128i RansDecode8(__m128i xa, __m128i& xb, const RansDecEntry* table, __m128i& syma, __m128i& symb)
+{
+    __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(xa), xb, 1);
+    __m256i e = _mm256_i32gather_epi32((const int*)table, _mm256_and_si256(x, _mm256_set1_epi32(kRansProbScale - 1)), 4);
+    __m256i freq = _mm256_srli_epi32(e, 20);
+    __m256i bias = _mm256_and_si256(_mm256_srli_epi32(e, 8), _mm256_set1_epi32(0xFFF));
+    __m256i sym = _mm256_and_si256(e, _mm256_set1_epi32(0xFF));
+    x = _mm256_add_epi32(_mm256_mullo_epi32(freq, _mm256_srli_epi32(x, kRansProbBits)), bias);
+    syma = _mm256_castsi256_si128(sym);
+    symb = _mm256_extracti128_si256(sym, 1);
+    xb = _mm256_extracti128_si256(x, 1);
+    return _mm256_castsi256_si128(x);
+}
+#endif // #if defined(__AVX2__)
+#endif // #if CPU_ARCH_X64
+
+static const uint8_t* RansDecodePlane(const uint8_t* src, const RansDecEntry* table, uint8_t* dst, size_t count)
+{
+    uint32_t state[kRansLanes];
+    memcpy(state, src, sizeof(state));
+    const uint8_t* ptr = src + sizeof(state);
+    size_t full = count / kRansLanes;
+    size_t g = 0;
+
+#if CPU_ARCH_X64
+    // 16 lanes in 4 registers; enough independent work to hide table lookup
+    // and multiply latencies
+    __m128i x0 = _mm_loadu_si128((const __m128i*)(state + 0));
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(state + 4));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(state + 8));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(state + 12));
+    for (; g < full; ++g)
+    {
+        __m128i sym0, sym1, sym2, sym3;
+#if defined(__AVX2__)
+        x0 = RansDecode8(x0, x1, table, sym0, sym1);
+        x2 = RansDecode8(x2, x3, table, sym2, sym3);
+#else
+        x0 = RansDecode4(x0, table, sym0);
+        x1 = RansDecode4(x1, table, sym1);
+        x2 = RansDecode4(x2, table, sym2);
+        x3 = RansDecode4(x3, table, sym3);
+#endif
+        __m128i s16a = _mm_packus_epi32(sym0, sym1);
+        __m128i s16b = _mm_packus_epi32(sym2, sym3);
+        _mm_storeu_si128((__m128i*)(dst + g * kRansLanes), _mm_packus_epi16(s16a, s16b));
+
+        // masks first, so that the stream pointer chain is just adds
+        int m0, m1, m2, m3;
+        __m128i n0 = RansRefillNeed(x0, m0);
+        __m128i n1 = RansRefillNeed(x1, m1);
+        __m128i n2 = RansRefillNeed(x2, m2);
+        __m128i n3 = RansRefillNeed(x3, m3);
+        x0 = RansRefill4(x0, n0, m0, ptr);
+        x1 = RansRefill4(x1, n1, m1, ptr);
+        x2 = RansRefill4(x2, n2, m2, ptr);
+        x3 = RansRefill4(x3, n3, m3, ptr);
+    }
+    _mm_storeu_si128((__m128i*)(state + 0), x0);
+    _mm_storeu_si128((__m128i*)(state + 4), x1);
+    _mm_storeu_si128((__m128i*)(state + 8), x2);
+    _mm_storeu_si128((__m128i*)(state + 12), x3);
+#endif
+
+    for (; g < full; ++g)
+    {
+        for (int j = 0; j < kRansLanes; ++j)
+            dst[g * kRansLanes + j] = RansDecGet(state[j], table);
+        for (int j = 0; j < kRansLanes; ++j)
+            RansDecRenorm(state[j], ptr);
+    }
+    size_t tail = count % kRansLanes;
+    for (size_t j = 0; j < tail; ++j)
+    {
+        dst[full * kRansLanes + j] = RansDecGet(state[j], table);
+        RansDecRenorm(state[j], ptr);
+    }
+    return ptr;
+}
+
+size_t rans_compress_bound(size_t srcSize)
+{
+    // worst case every plane is stored raw
+    return sizeof(RansHeader) + srcSize + kRansMaxPlanes * 5 + kRansPad;
+}
+
+size_t rans_compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize, int planes)
+{
+    planes = std::clamp(planes, 1, kRansMaxPlanes);
+    if (srcSize < size_t(planes))
+        planes = 1;
+    RansHeader* hdr = (RansHeader*)dst;
+    hdr->size = uint32_t(srcSize);
+    hdr->planes = uint32_t(planes);
+    uint8_t* out = dst + sizeof(RansHeader);
+
+    const size_t planeSize = srcSize / planes;
+    for (int ip = 0; ip < planes; ++ip)
+    {
+        const uint8_t* ps = src + ip * planeSize;
+        size_t count = ip == planes - 1 ? srcSize - ip * planeSize : planeSize;
+
+        uint32_t counts[256] = {};
+        for (size_t i = 0; i < count; ++i)
+            counts[ps[i]]++;
+        int used = 0;
+        for (int i = 0; i < 256; ++i)
+            used += counts[i] ? 1 : 0;
+        if (used <= 1)
+        {
+            *out++ = kRansPlaneConstant;
+            *out++ = count ? ps[0] : 0;
+            continue;
+        }
+
+        uint32_t freqs[256];
+        RansNormalizeFreqs(counts, count, freqs);
+        // stream is encoded backwards at the end of tmp; raw fallback if it
+        // does not fit or is not smaller
+        uint8_t tableBuf[32 + 512];
+        size_t tableSize = RansWriteFreqs(freqs, tableBuf);
+        size_t streamSize = 0;
+        if (tableSize + 4 + kRansLanes * 4 < count)
+        {
+            // worst case is 12 bits per symbol, i.e. below count * 2 bytes
+            std::vector<uint8_t> enc(count * 2 + kRansLanes * 4 + 16);
+            uint8_t* encEnd = enc.data() + enc.size();
+            uint8_t* encStart = RansEncodePlane(ps, count, freqs, encEnd);
+            streamSize = encEnd - encStart;
+            if (1 + tableSize + 4 + streamSize < 1 + count)
+            {
+                *out++ = kRansPlaneCoded;
+                memcpy(out, tableBuf, tableSize);
+                out += tableSize;
+                memcpy(out, &streamSize, 4);
+                out += 4;
+                memcpy(out, encStart, streamSize);
+                out += streamSize;
+                continue;
+            }
+        }
+        *out++ = kRansPlaneRaw;
+        memcpy(out, ps, count);
+        out += count;
+    }
+    memset(out, 0, kRansPad);
+    out += kRansPad;
+    return out - dst;
+}
+
+size_t rans_decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+    const RansHeader* hdr = (const RansHeader*)src;
+    const size_t size = hdr->size;
+    const int planes = int(hdr->planes);
+    if (size > dstSize)
+        return 0;
+    const uint8_t* in = src + sizeof(RansHeader);
+    const size_t planeSize = size / planes;
+    std::vector<RansDecEntry> table(kRansProbScale);
+    for (int ip = 0; ip < planes; ++ip)
+    {
+        uint8_t* pd = dst + ip * planeSize;
+        size_t count = ip == planes - 1 ? size - ip * planeSize : planeSize;
+        uint8_t mode = *in++;
+        if (mode == kRansPlaneConstant)
+        {
+            memset(pd, *in++, count);
+        }
+        else if (mode == kRansPlaneRaw)
+        {
+            memcpy(pd, in, count);
+            in += count;
+        }
+        else
+        {
+            uint32_t freqs[256];
+            in = RansReadFreqs(in, freqs);
+            uint32_t streamSize;
+            memcpy(&streamSize, in, 4);
+            in += 4;
+            RansBuildDecodeTable(freqs, table.data());
+            RansDecodePlane(in, table.data(), pd, count);
+            in += streamSize;
+        }
+    }
+    return size;
+}
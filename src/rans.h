@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Order-0 static rANS entropy coder for byte plane split data: input is treated as
+// `planes` equally sized contiguous byte planes (as produced by the split filters),
+// each with its own frequency table (12 bit precision). Every plane is coded as 16
+// interleaved rANS states (32 bit, 16 bit renormalization) sharing one word stream,
+// so that decoding processes 16 symbols at once with SSE4.1 (or AVX2 gathers when
+// compiled for it).
+// Constant planes are stored as a single byte, incompressible planes are stored raw.
+size_t rans_compress_bound(size_t srcSize);
+size_t rans_compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize, int planes);
+size_t rans_decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
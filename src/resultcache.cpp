@@ -64,7 +64,7 @@ void ResCacheClose()
 	s_CacheModified = false;
 }
 
-bool ResCacheGet(const char* name, int level, size_t* outSize, double* outCmpTime, double* outDecTime)
+bool ResCacheGet(const char* name, int level, size_t* outSize, double* outCmpTime, double* outDecTime, double* outMaxErr, double* outRmsErr, std::vector<double>* outChanRelErr)
 {
 #ifdef _DEBUG
 	return false;
@@ -78,17 +78,31 @@ bool ResCacheGet(const char* name, int level, size_t* outSize, double* outCmpTim
 		return false;
 	const char* propValue = ini_property_value(s_Cache, s_CacheSectionIndex, propIndex);
 	size_t size;
-	double cmpTime, decTime;
-	int parsed = sscanf(propValue, "%zi %lf %lf", &size, &cmpTime, &decTime);
-	if (parsed != 3)
+	double cmpTime, decTime, maxErr = 0.0, rmsErr = 0.0;
+	int pos = 0;
+	int parsed = sscanf(propValue, "%zi %lf %lf%n %lf %lf%n", &size, &cmpTime, &decTime, &pos, &maxErr, &rmsErr, &pos);
+	if (parsed != 3 && parsed != 5)
 		return false;
+	if (outChanRelErr)
+	{
+		outChanRelErr->clear();
+		double v;
+		int n;
+		while (sscanf(propValue + pos, " %lf%n", &v, &n) == 1)
+		{
+			outChanRelErr->push_back(v);
+			pos += n;
+		}
+	}
 	*outSize = size;
 	*outCmpTime = cmpTime;
 	*outDecTime = decTime;
+	if (outMaxErr) *outMaxErr = maxErr;
+	if (outRmsErr) *outRmsErr = rmsErr;
 	return true;
 }
 
-void ResCacheSet(const char* name, int level, size_t size, double cmpTime, double decTime)
+void ResCacheSet(const char* name, int level, size_t size, double cmpTime, double decTime, double maxErr, double rmsErr, const std::vector<double>* chanRelErr)
 {
 #ifdef _DEBUG
 	return;
@@ -96,7 +110,17 @@ void ResCacheSet(const char* name, int level, size_t size, double cmpTime, doubl
 
 	s_CacheModified = true;
 	char propValue[1024];
-	snprintf(propValue, sizeof(propValue), "%zi %.4lf %.4lf", size, cmpTime, decTime);
+	if (maxErr != 0.0 || rmsErr != 0.0 || (chanRelErr && !chanRelErr->empty()))
+	{
+		int len = snprintf(propValue, sizeof(propValue), "%zi %.4lf %.4lf %g %g", size, cmpTime, decTime, maxErr, rmsErr);
+		if (chanRelErr)
+		{
+			for (double v : *chanRelErr)
+				len += snprintf(propValue + len, sizeof(propValue) - len, " %g", v);
+		}
+	}
+	else
+		snprintf(propValue, sizeof(propValue), "%zi %.4lf %.4lf", size, cmpTime, decTime);
 
 	char propName[1024];
 	snprintf(propName, sizeof(propName), "%s_%i", name, level);
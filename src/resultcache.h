@@ -1,9 +1,11 @@
 ﻿#pragma once
 
 #include <stddef.h>
+#include <vector>
 
 void ResCacheInit();
 void ResCacheClose();
 
-bool ResCacheGet(const char* name, int level, size_t* outSize, double* outCmpTime, double* outDecTime);
-void ResCacheSet(const char* name, int level, size_t size, double cmpTime, double decTime);
+// lossy compressors additionally store max and RMS error of the decompressed data, and max relative error per channel
+bool ResCacheGet(const char* name, int level, size_t* outSize, double* outCmpTime, double* outDecTime, double* outMaxErr = nullptr, double* outRmsErr = nullptr, std::vector<double>* outChanRelErr = nullptr);
+void ResCacheSet(const char* name, int level, size_t size, double cmpTime, double decTime, double maxErr = 0.0, double rmsErr = 0.0, const std::vector<double>* chanRelErr = nullptr);
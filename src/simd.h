@@ -35,6 +35,10 @@ inline Bytes16 SimdInterleaveL(Bytes16 a, Bytes16 b) { return _mm_unpacklo_epi8(
 inline Bytes16 SimdInterleaveR(Bytes16 a, Bytes16 b) { return _mm_unpackhi_epi8(a, b); }
 inline Bytes16 SimdInterleave4L(Bytes16 a, Bytes16 b) { return _mm_unpacklo_epi32(a, b); }
 inline Bytes16 SimdInterleave4R(Bytes16 a, Bytes16 b) { return _mm_unpackhi_epi32(a, b); }
+inline Bytes16 SimdInterleave2L(Bytes16 a, Bytes16 b) { return _mm_unpacklo_epi16(a, b); }
+inline Bytes16 SimdInterleave2R(Bytes16 a, Bytes16 b) { return _mm_unpackhi_epi16(a, b); }
+inline Bytes16 SimdInterleave8L(Bytes16 a, Bytes16 b) { return _mm_unpacklo_epi64(a, b); }
+inline Bytes16 SimdInterleave8R(Bytes16 a, Bytes16 b) { return _mm_unpackhi_epi64(a, b); }
 
 inline Bytes16 SimdPrefixSum(Bytes16 x)
 {
@@ -46,6 +50,21 @@ inline Bytes16 SimdPrefixSum(Bytes16 x)
     return x;
 }
 
+// 4x 32 bit lane operations
+inline Bytes16 SimdSet1U32(uint32_t v) { return _mm_set1_epi32(int(v)); }
+inline Bytes16 SimdAnd(Bytes16 a, Bytes16 b) { return _mm_and_si128(a, b); }
+inline Bytes16 SimdOr(Bytes16 a, Bytes16 b) { return _mm_or_si128(a, b); }
+inline Bytes16 SimdXor(Bytes16 a, Bytes16 b) { return _mm_xor_si128(a, b); }
+inline Bytes16 SimdCmpEq(Bytes16 a, Bytes16 b) { return _mm_cmpeq_epi8(a, b); }
+// top bit of each byte, into the low 16 bits of the result
+inline uint32_t SimdMoveMask(Bytes16 x) { return uint32_t(_mm_movemask_epi8(x)); }
+inline Bytes16 SimdAddU32(Bytes16 a, Bytes16 b) { return _mm_add_epi32(a, b); }
+inline Bytes16 SimdSubU32(Bytes16 a, Bytes16 b) { return _mm_sub_epi32(a, b); }
+inline Bytes16 SimdShiftLeftU32(Bytes16 x, int bits) { return _mm_sll_epi32(x, _mm_cvtsi32_si128(bits)); }
+inline Bytes16 SimdShiftRightU32(Bytes16 x, int bits) { return _mm_srl_epi32(x, _mm_cvtsi32_si128(bits)); }
+// int32 lanes to float32 lanes, then multiply by a and b (in that order)
+inline Bytes16 SimdIntToFloatMul(Bytes16 x, float a, float b) { return _mm_castps_si128(_mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(x), _mm_set1_ps(a)), _mm_set1_ps(b))); }
+
 #elif CPU_ARCH_ARM64
 typedef uint8x16_t Bytes16;
 inline Bytes16 SimdZero() { return vdupq_n_u8(0); }
@@ -67,6 +86,10 @@ inline Bytes16 SimdInterleaveL(Bytes16 a, Bytes16 b) { return vzip1q_u8(a, b); }
 inline Bytes16 SimdInterleaveR(Bytes16 a, Bytes16 b) { return vzip2q_u8(a, b); }
 inline Bytes16 SimdInterleave4L(Bytes16 a, Bytes16 b) { return vreinterpretq_u8_u32(vzip1q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b))); }
 inline Bytes16 SimdInterleave4R(Bytes16 a, Bytes16 b) { return vreinterpretq_u8_u32(vzip2q_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b))); }
+inline Bytes16 SimdInterleave2L(Bytes16 a, Bytes16 b) { return vreinterpretq_u8_u16(vzip1q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b))); }
+inline Bytes16 SimdInterleave2R(Bytes16 a, Bytes16 b) { return vreinterpretq_u8_u16(vzip2q_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b))); }
+inline Bytes16 SimdInterleave8L(Bytes16 a, Bytes16 b) { return vreinterpretq_u8_u64(vzip1q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b))); }
+inline Bytes16 SimdInterleave8R(Bytes16 a, Bytes16 b) { return vreinterpretq_u8_u64(vzip2q_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b))); }
 
 
 inline Bytes16 SimdPrefixSum(Bytes16 x)
@@ -80,4 +103,24 @@ inline Bytes16 SimdPrefixSum(Bytes16 x)
     return x;
 }
 
+// 4x 32 bit lane operations
+inline Bytes16 SimdSet1U32(uint32_t v) { return vreinterpretq_u8_u32(vdupq_n_u32(v)); }
+inline Bytes16 SimdAnd(Bytes16 a, Bytes16 b) { return vandq_u8(a, b); }
+inline Bytes16 SimdOr(Bytes16 a, Bytes16 b) { return vorrq_u8(a, b); }
+inline Bytes16 SimdXor(Bytes16 a, Bytes16 b) { return veorq_u8(a, b); }
+inline Bytes16 SimdCmpEq(Bytes16 a, Bytes16 b) { return vceqq_u8(a, b); }
+// top bit of each byte, into the low 16 bits of the result
+inline uint32_t SimdMoveMask(Bytes16 x)
+{
+    static const int8_t kShifts[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7 };
+    uint8x16_t bits = vshlq_u8(vshrq_n_u8(x, 7), vld1q_s8(kShifts));
+    return vaddv_u8(vget_low_u8(bits)) | (uint32_t(vaddv_u8(vget_high_u8(bits))) << 8);
+}
+inline Bytes16 SimdAddU32(Bytes16 a, Bytes16 b) { return vreinterpretq_u8_u32(vaddq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b))); }
+inline Bytes16 SimdSubU32(Bytes16 a, Bytes16 b) { return vreinterpretq_u8_u32(vsubq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b))); }
+inline Bytes16 SimdShiftLeftU32(Bytes16 x, int bits) { return vreinterpretq_u8_u32(vshlq_u32(vreinterpretq_u32_u8(x), vdupq_n_s32(bits))); }
+inline Bytes16 SimdShiftRightU32(Bytes16 x, int bits) { return vreinterpretq_u8_u32(vshlq_u32(vreinterpretq_u32_u8(x), vdupq_n_s32(-bits))); }
+// int32 lanes to float32 lanes, then multiply by a and b (in that order)
+inline Bytes16 SimdIntToFloatMul(Bytes16 x, float a, float b) { return vreinterpretq_u8_f32(vmulq_n_f32(vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u8(x)), a), b)); }
+
 #endif
@@ -0,0 +1,219 @@
+#include "spdp_mt.h"
+#include "parallel.h"
+#include "simd.h"
+#include "../libs/spdp/spdp_11.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+// 32 bit words: out[i] = in[i] - in[i-2]; trailing bytes that do not make up a word are copied
+static void WordDelta2(const uint8_t* src, uint8_t* dst, size_t length)
+{
+    const size_t len = length / 4;
+    const uint32_t* in = (const uint32_t*)src;
+    uint32_t* out = (uint32_t*)dst;
+    size_t i = 0;
+    for (; i < len && i < 2; ++i)
+        out[i] = in[i];
+    for (; i + 4 <= len; i += 4)
+        SimdStore(out + i, SimdSubU32(SimdLoad(in + i), SimdLoad(in + i - 2)));
+    for (; i < len; ++i)
+        out[i] = in[i] - in[i - 2];
+    memcpy(dst + len * 4, src + len * 4, length - len * 4);
+}
+
+static void WordUnDelta2(const uint8_t* src, uint8_t* dst, size_t length)
+{
+    const size_t len = length / 4;
+    const uint32_t* in = (const uint32_t*)src;
+    uint32_t* out = (uint32_t*)dst;
+    static const uint8_t kDupHiTable[16] = { 8, 9, 10, 11, 12, 13, 14, 15, 8, 9, 10, 11, 12, 13, 14, 15 };
+    const Bytes16 kDupHi = SimdLoad(kDupHiTable);
+    Bytes16 prev = SimdZero();
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4)
+    {
+        // [a,b,c,d] -> [a,b,c+a,d+b], then add [p2,p3,p2,p3] of previous result
+        Bytes16 x = SimdLoad(in + i);
+        x = SimdAddU32(x, SimdConcat<8>(x, SimdZero()));
+        x = SimdAddU32(x, SimdShuffle(prev, kDupHi));
+        SimdStore(out + i, x);
+        prev = x;
+    }
+    for (; i < len; ++i)
+        out[i] = in[i] + (i >= 2 ? out[i - 2] : 0);
+    memcpy(dst + len * 4, src + len * 4, length - len * 4);
+}
+
+// transpose of 8x8 matrix of 16 bit elements (row i: v[i])
+static inline void Transpose8x8U16(Bytes16 v[8])
+{
+    Bytes16 a0 = SimdInterleave2L(v[0], v[1]), a1 = SimdInterleave2R(v[0], v[1]);
+    Bytes16 a2 = SimdInterleave2L(v[2], v[3]), a3 = SimdInterleave2R(v[2], v[3]);
+    Bytes16 a4 = SimdInterleave2L(v[4], v[5]), a5 = SimdInterleave2R(v[4], v[5]);
+    Bytes16 a6 = SimdInterleave2L(v[6], v[7]), a7 = SimdInterleave2R(v[6], v[7]);
+    Bytes16 b0 = SimdInterleave4L(a0, a2), b1 = SimdInterleave4R(a0, a2);
+    Bytes16 b2 = SimdInterleave4L(a1, a3), b3 = SimdInterleave4R(a1, a3);
+    Bytes16 b4 = SimdInterleave4L(a4, a6), b5 = SimdInterleave4R(a4, a6);
+    Bytes16 b6 = SimdInterleave4L(a5, a7), b7 = SimdInterleave4R(a5, a7);
+    v[0] = SimdInterleave8L(b0, b4); v[1] = SimdInterleave8R(b0, b4);
+    v[2] = SimdInterleave8L(b1, b5); v[3] = SimdInterleave8R(b1, b5);
+    v[4] = SimdInterleave8L(b2, b6); v[5] = SimdInterleave8R(b2, b6);
+    v[6] = SimdInterleave8L(b3, b7); v[7] = SimdInterleave8R(b3, b7);
+}
+
+// SPDP byte order: all bytes at offset 0 of each 8 byte group, then all bytes at offset 1, etc.
+static void GetPlaneStarts(size_t length, size_t starts[8])
+{
+    const size_t n = length / 8, r = length % 8;
+    for (size_t d = 0; d < 8; ++d)
+        starts[d] = d * n + std::min(d, r);
+}
+
+// transposes into 8 byte planes, and deltas bytes of the result: dst[i] = x[i] - x[i-1]
+static void ByteSplit8Delta(const uint8_t* src, uint8_t* tmp, uint8_t* dst, size_t length)
+{
+    const size_t n = length / 8, r = length % 8;
+    size_t starts[8];
+    GetPlaneStarts(length, starts);
+
+    // 16 groups of 8 bytes at once: pair up bytes of two groups, then 8x8 transpose of the pairs
+    static const uint8_t kPairTable[16] = { 0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15 };
+    const Bytes16 kPair = SimdLoad(kPairTable);
+    size_t g = 0;
+    for (; g + 16 <= n; g += 16)
+    {
+        Bytes16 v[8];
+        for (int k = 0; k < 8; ++k)
+            v[k] = SimdShuffle(SimdLoad(src + g * 8 + k * 16), kPair);
+        Transpose8x8U16(v);
+        for (int d = 0; d < 8; ++d)
+            SimdStore(tmp + starts[d] + g, v[d]);
+    }
+    for (size_t d = 0; d < 8; ++d)
+    {
+        size_t planeSize = n + (d < r ? 1 : 0);
+        for (size_t gg = g; gg < planeSize; ++gg)
+            tmp[starts[d] + gg] = src[gg * 8 + d];
+    }
+
+    size_t i = 0;
+    if (length > 0)
+        dst[i++] = tmp[0];
+    for (; i + 16 <= length; i += 16)
+        SimdStore(dst + i, SimdSub(SimdLoad(tmp + i), SimdLoad(tmp + i - 1)));
+    for (; i < length; ++i)
+        dst[i] = tmp[i] - tmp[i - 1];
+}
+
+static void ByteUnDeltaUnSplit8(const uint8_t* src, uint8_t* tmp, uint8_t* dst, size_t length)
+{
+    const Bytes16 kLast = SimdSet1(15);
+    Bytes16 prev = SimdZero();
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        Bytes16 x = SimdAdd(SimdPrefixSum(SimdLoad(src + i)), prev);
+        SimdStore(tmp + i, x);
+        prev = SimdShuffle(x, kLast);
+    }
+    for (; i < length; ++i)
+        tmp[i] = src[i] + (i > 0 ? tmp[i - 1] : 0);
+
+    const size_t n = length / 8, r = length % 8;
+    size_t starts[8];
+    GetPlaneStarts(length, starts);
+    static const uint8_t kUnpairTable[16] = { 0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15 };
+    const Bytes16 kUnpair = SimdLoad(kUnpairTable);
+    size_t g = 0;
+    for (; g + 16 <= n; g += 16)
+    {
+        Bytes16 v[8];
+        for (int d = 0; d < 8; ++d)
+            v[d] = SimdLoad(tmp + starts[d] + g);
+        Transpose8x8U16(v);
+        for (int k = 0; k < 8; ++k)
+            SimdStore(dst + g * 8 + k * 16, SimdShuffle(v[k], kUnpair));
+    }
+    for (size_t d = 0; d < 8; ++d)
+    {
+        size_t planeSize = n + (d < r ? 1 : 0);
+        for (size_t gg = g; gg < planeSize; ++gg)
+            dst[gg * 8 + d] = tmp[starts[d] + gg];
+    }
+}
+
+size_t spdp_mt_compress_bound(size_t size, size_t chunkSize)
+{
+    size_t chunkCount = (size + chunkSize - 1) / chunkSize;
+    return 1 + size * 2 + chunkCount * (8 + 9);
+}
+
+size_t spdp_mt_compress(int level, const uint8_t* src, size_t size, size_t chunkSize, int threadCount, uint8_t* dst)
+{
+    level = std::clamp(level, 0, 9);
+    int chunkCount = int((size + chunkSize - 1) / chunkSize);
+    std::vector<uint8_t*> chunks(chunkCount);
+    std::vector<size_t> chunkSizes(chunkCount);
+    ParallelFor(chunkCount, threadCount, [&](int index, int)
+    {
+        size_t offset = index * chunkSize;
+        size_t length = std::min(chunkSize, size - offset);
+        uint8_t* bufA = new uint8_t[length];
+        uint8_t* bufB = new uint8_t[length];
+        WordDelta2(src + offset, bufA, length);
+        ByteSplit8Delta(bufA, bufB, bufA, length);
+        delete[] bufB;
+        uint8_t* chunk = new uint8_t[8 + spdp_compress_bound(length)];
+        int32_t lengths[2] = { int32_t(length), 0 };
+        lengths[1] = int32_t(spdp_compress_lz(byte_t(level), length, bufA, chunk + 8));
+        memcpy(chunk, lengths, 8);
+        delete[] bufA;
+        chunks[index] = chunk;
+        chunkSizes[index] = 8 + lengths[1];
+    });
+
+    uint8_t* ptr = dst;
+    *ptr++ = uint8_t(level);
+    for (int i = 0; i < chunkCount; ++i)
+    {
+        memcpy(ptr, chunks[i], chunkSizes[i]);
+        ptr += chunkSizes[i];
+        delete[] chunks[i];
+    }
+    return ptr - dst;
+}
+
+void spdp_mt_decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize, int threadCount)
+{
+    struct Chunk
+    {
+        const uint8_t* src;
+        size_t srcSize;
+        size_t dstOffset;
+        size_t dstSize;
+    };
+    const uint8_t level = src[0];
+    std::vector<Chunk> chunks;
+    size_t pos = 1, dstPos = 0;
+    while (pos + 8 <= srcSize)
+    {
+        int32_t lengths[2];
+        memcpy(lengths, src + pos, 8);
+        chunks.push_back({ src + pos + 8, size_t(lengths[1]), dstPos, size_t(lengths[0]) });
+        pos += 8 + lengths[1];
+        dstPos += lengths[0];
+    }
+
+    ParallelFor(int(chunks.size()), threadCount, [&](int index, int)
+    {
+        const Chunk& chunk = chunks[index];
+        uint8_t* bufA = new uint8_t[chunk.dstSize];
+        uint8_t* bufB = new uint8_t[chunk.dstSize];
+        spdp_decompress_lz(level, chunk.srcSize, chunk.src, bufA);
+        ByteUnDeltaUnSplit8(bufA, bufB, bufA, chunk.dstSize);
+        WordUnDelta2(bufA, dst + chunk.dstOffset, chunk.dstSize);
+        delete[] bufB;
+        delete[] bufA;
+    });
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// SPDP (Claggett et al. 2018) on independent chunks, multithreaded: input is cut into
+// chunkSize byte chunks, each one is compressed into exactly what spdp_compress would
+// produce for it, but with the word delta and byte transpose + delta stages done with SIMD.
+// Chunks are compressed and decompressed in parallel (threadCount 0: all hardware threads).
+// Output is the same as the SPDP 1.1 command line tool stream: level byte, then for each
+// chunk int32 uncompressed length, int32 compressed length, compressed data.
+size_t spdp_mt_compress_bound(size_t size, size_t chunkSize);
+size_t spdp_mt_compress(int level, const uint8_t* src, size_t size, size_t chunkSize, int threadCount, uint8_t* dst);
+void spdp_mt_decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize, int threadCount);
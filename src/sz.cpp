@@ -0,0 +1,348 @@
+#include "sz.h"
+#include "parallel.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+static const int kSzBandRows = 64;
+static const int kSzBandElems1D = 64 * 1024;
+static const int kSzBlockSize2D = 16;
+static const int kSzBlockSize1D = 256;
+static const int kSzRadius = 32768; // codes 1 .. 2*radius-1 are bins, 0 is unpredictable value
+static const int kSzEntropyLevel = 3;
+
+struct SzHeader
+{
+    double errorBound;
+    uint32_t bandCount;
+    uint32_t format;
+};
+
+struct SzBandHeader
+{
+    uint32_t codesSize;
+    uint32_t regressionCount;
+    uint32_t unpredCount;
+    uint32_t pad;
+    // followed by: entropy coded codes (low byte plane, high byte plane), block flags
+    // (1 byte per block per channel, padded to 4), regression coefficients (3 floats
+    // each), unpredictable values
+};
+
+struct SzBand
+{
+    int x0, y0, w, h;
+    int blockW, blockH;
+    int blocksX, blocksY;
+};
+
+static int SzBandCount(int width, int height)
+{
+    if (height == 1)
+        return (width + kSzBandElems1D - 1) / kSzBandElems1D;
+    return (height + kSzBandRows - 1) / kSzBandRows;
+}
+
+static SzBand SzGetBand(int width, int height, int index)
+{
+    SzBand b;
+    if (height == 1)
+    {
+        b.x0 = index * kSzBandElems1D;
+        b.y0 = 0;
+        b.w = std::min(kSzBandElems1D, width - b.x0);
+        b.h = 1;
+        b.blockW = kSzBlockSize1D;
+        b.blockH = 1;
+    }
+    else
+    {
+        b.x0 = 0;
+        b.y0 = index * kSzBandRows;
+        b.w = width;
+        b.h = std::min(kSzBandRows, height - b.y0);
+        b.blockW = b.blockH = kSzBlockSize2D;
+    }
+    b.blocksX = (b.w + b.blockW - 1) / b.blockW;
+    b.blocksY = (b.h + b.blockH - 1) / b.blockH;
+    return b;
+}
+
+// Prediction and reconstruction are shared by encoder and decoder, so that both compute
+// bit-identical values.
+static inline float SzLorenzo(const float* r, int x, int y, int w)
+{
+    if (x > 0 && y > 0)
+        return r[-1] + r[-w] - r[-w - 1];
+    if (x > 0)
+        return r[-1];
+    if (y > 0)
+        return r[-w];
+    return 0.0f;
+}
+
+static inline float SzRegression(const float* c, int bx, int by, float cx, float cy)
+{
+    return c[0] + c[1] * (float(bx) - cx) + c[2] * (float(by) - cy);
+}
+
+static inline float SzReconstruct(float pred, int q, double eb2)
+{
+    return float(pred + q * eb2);
+}
+
+static size_t SzBandBound(const SzBand& b, int channels, CompressionFormat format)
+{
+    size_t elems = size_t(b.w) * b.h * channels;
+    size_t blocks = size_t(b.blocksX) * b.blocksY * channels;
+    return sizeof(SzBandHeader) + compress_calc_bound(elems * 2, format) + ((blocks + 3) & ~3) + blocks * 12 + elems * 4;
+}
+
+static size_t SzEncodeBand(const float* src, int width, int channels, const SzBand& b, double eb, CompressionFormat format, uint8_t* dst)
+{
+    const double eb2 = eb * 2;
+    const size_t bandElems = size_t(b.w) * b.h;
+    const int blockCount = b.blocksX * b.blocksY;
+    std::vector<uint16_t> codes(bandElems * channels);
+    std::vector<uint8_t> flags(blockCount * channels);
+    std::vector<float> coeffs, unpred;
+    std::vector<float> orig(bandElems), recon(bandElems);
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        // band of this channel into contiguous memory
+        for (int y = 0; y < b.h; ++y)
+            for (int x = 0; x < b.w; ++x)
+                orig[y * b.w + x] = src[(size_t(b.y0 + y) * width + b.x0 + x) * channels + ch];
+
+        // per block: fit regression plane, and pick it if it predicts original data better than Lorenzo
+        uint8_t* blockFlags = flags.data() + ch * blockCount;
+        std::vector<int> blockCoeffs(blockCount, -1);
+        for (int by = 0; by < b.blocksY; ++by)
+        {
+            for (int bx = 0; bx < b.blocksX; ++bx)
+            {
+                const int x0 = bx * b.blockW, y0 = by * b.blockH;
+                const int bw = std::min(b.blockW, b.w - x0), bh = std::min(b.blockH, b.h - y0);
+                const double cx = (bw - 1) * 0.5, cy = (bh - 1) * 0.5;
+                double sum = 0, sumX = 0, sumY = 0, sumXX = 0, sumYY = 0;
+                bool finite = true;
+                for (int y = 0; y < bh; ++y)
+                {
+                    for (int x = 0; x < bw; ++x)
+                    {
+                        double v = orig[(y0 + y) * b.w + x0 + x];
+                        finite &= isfinite(v);
+                        sum += v;
+                        sumX += (x - cx) * v;
+                        sumY += (y - cy) * v;
+                        sumXX += (x - cx) * (x - cx);
+                        sumYY += (y - cy) * (y - cy);
+                    }
+                }
+                blockFlags[by * b.blocksX + bx] = 0;
+                if (!finite || bw * bh < 4)
+                    continue;
+                float c[3] = { float(sum / (bw * bh)), float(sumXX > 0 ? sumX / sumXX : 0), float(sumYY > 0 ? sumY / sumYY : 0) };
+                double errLorenzo = 0, errRegression = 0;
+                for (int y = 0; y < bh; ++y)
+                {
+                    for (int x = 0; x < bw; ++x)
+                    {
+                        int idx = (y0 + y) * b.w + x0 + x;
+                        errLorenzo += fabs(orig[idx] - SzLorenzo(&orig[idx], x0 + x, y0 + y, b.w));
+                        errRegression += fabs(orig[idx] - SzRegression(c, x, y, float(cx), float(cy)));
+                    }
+                }
+                if (errRegression < errLorenzo)
+                {
+                    blockFlags[by * b.blocksX + bx] = 1;
+                    blockCoeffs[by * b.blocksX + bx] = int(coeffs.size());
+                    coeffs.insert(coeffs.end(), c, c + 3);
+                }
+            }
+        }
+
+        // predict from reconstructed data, quantize
+        uint16_t* code = codes.data() + ch * bandElems;
+        for (int y = 0; y < b.h; ++y)
+        {
+            const int by = y / b.blockH;
+            for (int x = 0; x < b.w; ++x)
+            {
+                const int bx = x / b.blockW;
+                const int idx = y * b.w + x;
+                const int coeffIdx = blockCoeffs[by * b.blocksX + bx];
+                float pred;
+                if (coeffIdx >= 0)
+                {
+                    const int bw = std::min(b.blockW, b.w - bx * b.blockW), bh = std::min(b.blockH, b.h - by * b.blockH);
+                    pred = SzRegression(&coeffs[coeffIdx], x - bx * b.blockW, y - by * b.blockH, (bw - 1) * 0.5f, (bh - 1) * 0.5f);
+                }
+                else
+                    pred = SzLorenzo(&recon[idx], x, y, b.w);
+
+                const float v = orig[idx];
+                double q = nearbyint((double(v) - pred) / eb2);
+                if (fabs(q) < kSzRadius)
+                {
+                    float r = SzReconstruct(pred, int(q), eb2);
+                    if (fabs(double(r) - v) <= eb)
+                    {
+                        code[idx] = uint16_t(int(q) + kSzRadius);
+                        recon[idx] = r;
+                        continue;
+                    }
+                }
+                // out of bins, rounding error over the bound, or NaN / inf
+                code[idx] = 0;
+                recon[idx] = v;
+                unpred.push_back(v);
+            }
+        }
+    }
+
+    // codes as low / high byte planes, entropy coded
+    const size_t codeCount = codes.size();
+    std::vector<uint8_t> planes(codeCount * 2);
+    for (size_t i = 0; i < codeCount; ++i)
+    {
+        planes[i] = uint8_t(codes[i]);
+        planes[codeCount + i] = uint8_t(codes[i] >> 8);
+    }
+    SzBandHeader* hdr = (SzBandHeader*)dst;
+    uint8_t* out = dst + sizeof(SzBandHeader);
+    hdr->codesSize = uint32_t(compress_data(planes.data(), planes.size(), out, compress_calc_bound(planes.size(), format), format, kSzEntropyLevel, 2));
+    hdr->regressionCount = uint32_t(coeffs.size() / 3);
+    hdr->unpredCount = uint32_t(unpred.size());
+    hdr->pad = 0;
+    out += hdr->codesSize;
+    memcpy(out, flags.data(), flags.size());
+    memset(out + flags.size(), 0, ((flags.size() + 3) & ~3) - flags.size());
+    out += (flags.size() + 3) & ~3;
+    memcpy(out, coeffs.data(), coeffs.size() * 4);
+    out += coeffs.size() * 4;
+    memcpy(out, unpred.data(), unpred.size() * 4);
+    out += unpred.size() * 4;
+    return out - dst;
+}
+
+static void SzDecodeBand(const uint8_t* src, float* dst, int width, int channels, const SzBand& b, double eb, CompressionFormat format)
+{
+    const double eb2 = eb * 2;
+    const size_t bandElems = size_t(b.w) * b.h;
+    const int blockCount = b.blocksX * b.blocksY;
+    const size_t codeCount = bandElems * channels;
+    const SzBandHeader* hdr = (const SzBandHeader*)src;
+    src += sizeof(SzBandHeader);
+    std::vector<uint8_t> planes(codeCount * 2);
+    decompress_data(src, hdr->codesSize, planes.data(), planes.size(), format);
+    src += hdr->codesSize;
+    const uint8_t* flags = src;
+    src += (size_t(blockCount) * channels + 3) & ~3;
+    const float* coeffs = (const float*)src;
+    src += hdr->regressionCount * 12;
+    const float* unpred = (const float*)src;
+
+    std::vector<int> blockCoeffs(blockCount);
+    std::vector<float> recon(bandElems);
+    int coeffIndex = 0;
+    const uint8_t* codesLo = planes.data();
+    const uint8_t* codesHi = planes.data() + codeCount;
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const uint8_t* blockFlags = flags + ch * blockCount;
+        for (int i = 0; i < blockCount; ++i)
+        {
+            blockCoeffs[i] = blockFlags[i] ? coeffIndex : -1;
+            coeffIndex += blockFlags[i] ? 3 : 0;
+        }
+
+        const size_t codeBase = ch * bandElems;
+        for (int y = 0; y < b.h; ++y)
+        {
+            const int by = y / b.blockH;
+            float* d = dst + (size_t(b.y0 + y) * width + b.x0) * channels + ch;
+            for (int x = 0; x < b.w; ++x)
+            {
+                const int bx = x / b.blockW;
+                const int idx = y * b.w + x;
+                const int code = codesLo[codeBase + idx] | (codesHi[codeBase + idx] << 8);
+                float v;
+                if (code == 0)
+                    v = *unpred++;
+                else
+                {
+                    const int bi = by * b.blocksX + bx;
+                    float pred;
+                    if (blockCoeffs[bi] >= 0)
+                    {
+                        const float* c = coeffs + blockCoeffs[bi];
+                        const int bw = std::min(b.blockW, b.w - bx * b.blockW), bh = std::min(b.blockH, b.h - by * b.blockH);
+                        pred = SzRegression(c, x - bx * b.blockW, y - by * b.blockH, (bw - 1) * 0.5f, (bh - 1) * 0.5f);
+                    }
+                    else
+                        pred = SzLorenzo(&recon[idx], x, y, b.w);
+                    v = SzReconstruct(pred, code - kSzRadius, eb2);
+                }
+                recon[idx] = v;
+                d[x * channels] = v;
+            }
+        }
+    }
+}
+
+size_t sz_compress_bound(int width, int height, int channels, CompressionFormat format)
+{
+    int bandCount = SzBandCount(width, height);
+    size_t bound = sizeof(SzHeader) + bandCount * 4;
+    for (int ib = 0; ib < bandCount; ++ib)
+        bound += SzBandBound(SzGetBand(width, height, ib), channels, format);
+    return bound;
+}
+
+size_t sz_compress(const float* src, int width, int height, int channels, double errorBound, CompressionFormat format, int threadCount, uint8_t* dst)
+{
+    const int bandCount = SzBandCount(width, height);
+    SzHeader* hdr = (SzHeader*)dst;
+    hdr->errorBound = errorBound;
+    hdr->bandCount = bandCount;
+    hdr->format = format;
+    uint32_t* bandSizes = (uint32_t*)(dst + sizeof(SzHeader));
+
+    std::vector<size_t> tmpOffsets(bandCount + 1, 0);
+    for (int ib = 0; ib < bandCount; ++ib)
+        tmpOffsets[ib + 1] = tmpOffsets[ib] + SzBandBound(SzGetBand(width, height, ib), channels, format);
+    std::vector<uint8_t> tmp(tmpOffsets[bandCount]);
+    ParallelFor(bandCount, threadCount, [&](int ib, int)
+    {
+        bandSizes[ib] = uint32_t(SzEncodeBand(src, width, channels, SzGetBand(width, height, ib), errorBound, format, tmp.data() + tmpOffsets[ib]));
+    });
+
+    uint8_t* out = dst + sizeof(SzHeader) + bandCount * 4;
+    for (int ib = 0; ib < bandCount; ++ib)
+    {
+        memcpy(out, tmp.data() + tmpOffsets[ib], bandSizes[ib]);
+        out += bandSizes[ib];
+    }
+    return out - dst;
+}
+
+void sz_decompress(const uint8_t* src, size_t srcSize, float* dst, int width, int height, int channels, int threadCount)
+{
+    const SzHeader* hdr = (const SzHeader*)src;
+    const int bandCount = hdr->bandCount;
+    const uint32_t* bandSizes = (const uint32_t*)(src + sizeof(SzHeader));
+    std::vector<size_t> bandOffsets(bandCount);
+    size_t offset = sizeof(SzHeader) + bandCount * 4;
+    for (int ib = 0; ib < bandCount; ++ib)
+    {
+        bandOffsets[ib] = offset;
+        offset += bandSizes[ib];
+    }
+    ParallelFor(bandCount, threadCount, [&](int ib, int)
+    {
+        SzDecodeBand(src + bandOffsets[ib], dst, width, channels, SzGetBand(width, height, ib), hdr->errorBound, (CompressionFormat)hdr->format);
+    });
+}
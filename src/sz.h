@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "compression_helpers.h"
+
+// SZ style (Di & Cappello 2016, Liang et al. 2018) error bounded lossy codec for 2D float
+// grids: each value is predicted either by 2D Lorenzo predictor from already reconstructed
+// neighbors, or by a linear regression plane fitted per 16x16 block (coefficients stored),
+// whichever fits the block better. Prediction residual is quantized into integer bins of
+// 2*errorBound width; values that do not fit the bins or the error bound are stored as is.
+// Bin codes are entropy coded with the given generic compressor (zstd / Huff0 / ...).
+// Data is coded in independent bands of rows (1D data: ranges of elements), so that both
+// compression and decompression run one band per thread. Each channel of interleaved data
+// is predicted separately.
+size_t sz_compress_bound(int width, int height, int channels, CompressionFormat format);
+size_t sz_compress(const float* src, int width, int height, int channels, double errorBound, CompressionFormat format, int threadCount, uint8_t* dst);
+void sz_decompress(const uint8_t* src, size_t srcSize, float* dst, int width, int height, int channels, int threadCount);